@@ -2,6 +2,7 @@
 #include <syntacts>
 #include <unordered_map>
 #include <iostream>
+#include <cstdint>
 
 using namespace tact;
 
@@ -22,9 +23,11 @@ Finalizer g_finalizer;
 
 template <typename S>
 inline Handle store(const S& s) {
-    Signal sig(s);
-    Handle h = sig.get();
-    g_sigs.emplace(h, std::move(sig));
+    // small Signals are stored inline and move with their Signal, so
+    // the handle can't be the address of the underlying type
+    static std::uintptr_t next = 0;
+    Handle h = reinterpret_cast<Handle>(++next);
+    g_sigs.emplace(h, Signal(s));
     return h;
 }
 
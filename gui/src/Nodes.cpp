@@ -101,15 +101,26 @@ std::shared_ptr<Node> makeOscNode(const tact::Signal& sig, int idx) {
 }
 
 bool recurseProduct(std::shared_ptr<ProductNode> root, const tact::Signal& sig) {
+    if (sig.isType<tact::Modulation>()) {
+        for (auto& s : sig.getAs<tact::Modulation>()->signals) {
+            if (s.isType<tact::Product>() || s.isType<tact::Modulation>())
+                recurseProduct(root, s);
+            else if (auto node = makeNode(s))
+                root->m_nodes.push_back(node);
+            else
+                return false;
+        }
+        return true;
+    }
     auto prod = sig.getAs<tact::Product>();
-    if (prod->lhs.isType<tact::Product>()) 
+    if (prod->lhs.isType<tact::Product>() || prod->lhs.isType<tact::Modulation>()) 
         recurseProduct(root, prod->lhs);    
     else if (auto lhs = makeNode(prod->lhs))
         root->m_nodes.push_back(lhs);    
     else
         return false;
 
-    if (prod->rhs.isType<tact::Product>()) 
+    if (prod->rhs.isType<tact::Product>() || prod->rhs.isType<tact::Modulation>()) 
         recurseProduct(root, prod->rhs);    
     else if (auto rhs = makeNode(prod->rhs))
         root->m_nodes.push_back(rhs);    
@@ -120,15 +131,26 @@ bool recurseProduct(std::shared_ptr<ProductNode> root, const tact::Signal& sig)
 }
 
 bool recurseSum(std::shared_ptr<SumNode> root, const tact::Signal& sig) {
+    if (sig.isType<tact::Mix>()) {
+        for (auto& s : sig.getAs<tact::Mix>()->signals) {
+            if (s.isType<tact::Sum>() || s.isType<tact::Mix>())
+                recurseSum(root, s);
+            else if (auto node = makeNode(s))
+                root->m_nodes.push_back(node);
+            else
+                return false;
+        }
+        return true;
+    }
     auto prod = sig.getAs<tact::Sum>();
-    if (prod->lhs.isType<tact::Sum>()) 
+    if (prod->lhs.isType<tact::Sum>() || prod->lhs.isType<tact::Mix>()) 
         recurseSum(root, prod->lhs);    
     else if (auto lhs = makeNode(prod->lhs))
         root->m_nodes.push_back(lhs);    
     else 
         return false;
 
-    if (prod->rhs.isType<tact::Sum>()) 
+    if (prod->rhs.isType<tact::Sum>() || prod->rhs.isType<tact::Mix>()) 
         recurseSum(root, prod->rhs);    
     else if (auto rhs = makeNode(prod->rhs))
         root->m_nodes.push_back(rhs); 
@@ -165,12 +187,12 @@ std::shared_ptr<Node> makeNode(const tact::Signal& sig) {
         return std::make_shared<PolyBezierNode>(sig);
     else if (sig.isType<tact::Samples>()) 
         return std::make_shared<SamplesNode>(sig);
-    else if (sig.isType<tact::Sum>()) {
+    else if (sig.isType<tact::Sum>() || sig.isType<tact::Mix>()) {
         auto node = std::make_shared<SumNode>();
         if (recurseSum(node, sig))
             return node;
     }
-    else if (sig.isType<tact::Product>()) {
+    else if (sig.isType<tact::Product>() || sig.isType<tact::Modulation>()) {
         auto node = std::make_shared<ProductNode>();
         if (recurseProduct(node, sig))
             return node;
@@ -213,7 +235,7 @@ std::shared_ptr<Node> makeNode(const tact::Signal& sig) {
 /// Make Node from Signal
 std::shared_ptr<Node> makeRoot(const tact::Signal& sig) {
     auto root = std::make_shared<ProductNode>();
-    if (sig.isType<tact::Product>()) {
+    if (sig.isType<tact::Product>() || sig.isType<tact::Modulation>()) {
         if (recurseProduct(root, sig))
             return root;
     }
@@ -380,7 +402,7 @@ SequencerNode::SequencerNode(tact::Sequence _seq) : SequencerNode() {
     for (int i = 0; i < key_count; ++i) {
         auto& key = seq.getKey(i);
         ImGui::SeqInterface::Track track;
-        track.signal    = key.signal;
+        track.signal    = *key.signal * key.gain;
         track.label     = "Track " + std::to_string(i+1);
         track.t         = key.t;
         track.populated = true;
@@ -641,6 +663,10 @@ void SamplesNode::update() {
     auto samples = sig.getAs<tact::Samples>();
     ImGui::Text("Sample Count: %d", samples->sampleCount());
     ImGui::Text("Sample Rate:  %.0f Hz", samples->sampleRate());
+    static const char* interpolations[] = {"Linear", "Cubic", "Nearest", "Sinc"};
+    int interpolation = (int)samples->interpolation;
+    if (ImGui::Combo("Interpolation", &interpolation, interpolations, 4))
+        samples->interpolation = (tact::Interpolation)interpolation;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -741,23 +767,23 @@ static const tact::Curve CURVES[] = {
 void KeyedEnvelopeNode::update() {
     auto cast = sig.getAs<tact::KeyedEnvelope>();
     Ts.clear(); As.clear(); Cs.clear();
-    int key_count = cast->keys.size();
-    int i = 0;
-    for (auto it = cast->keys.begin(); it != cast->keys.end(); ++it) {
-        double t       = it->first;
-        double a       = it->second.first;
-        tact::Curve c  = it->second.second;
-        bool first_key = it == cast->keys.begin();
-        bool last_key  = std::next(it) == cast->keys.end();
+    auto keys = cast->getKeys();
+    int key_count = (int)keys.size();
+    for (int i = 0; i < key_count; ++i) {
+        double t       = keys[i].t;
+        double a       = keys[i].amplitude;
+        tact::Curve c  = keys[i].curve;
+        bool first_key = i == 0;
+        bool last_key  = i == key_count - 1;
         double tprev, tnext;
         if (first_key)
             tprev = 0;
         else 
-            tprev = std::prev(it)->first;
+            tprev = keys[i-1].t;
         if (last_key)
             tnext = 0;
         else
-            tnext = std::next(it)->first;   
+            tnext = keys[i+1].t;   
         double tmin = first_key ? 0 : tprev + 0.001;
         double tmax = last_key  ? t + 1000 : tnext - 0.001; 
         ImGui::PushID(i);
@@ -794,9 +820,8 @@ void KeyedEnvelopeNode::update() {
             Cs.push_back(tact::Curves::Linear());
         }       
         ImGui::PopID();
-        i++;
     }
-    cast->keys.clear();
+    cast->clearKeys();
     for (int i = 0; i < Ts.size(); ++i) 
         cast->addKey(Ts[i], As[i], Cs[i]);    
 }
@@ -807,18 +832,17 @@ void ASRNode::update()
 {
     static const float minDur = 0.001f;
     auto cast = (tact::ASR *)sig.get();
-    auto it = cast->keys.begin();
-    it++;
-    auto &a = *(it++);
-    auto &s = *(it++);
-    auto &r = *(it++);
+    auto &keys = cast->getKeys();
+    auto &a = keys[1];
+    auto &s = keys[2];
+    auto &r = keys[3];
 
     float asr[3];
-    asr[0] = a.first;
-    asr[1] = s.first - a.first;
-    asr[2] = r.first - s.first;
+    asr[0] = a.t;
+    asr[1] = s.t - a.t;
+    asr[2] = r.t - s.t;
 
-    float amp = a.second.first;
+    float amp = a.amplitude;
 
     bool changed = false;
     if (ImGui::DragFloat3("Durations", asr, 0.001f, minDur, 1.0f, "%0.3f s"))
@@ -843,20 +867,19 @@ void ADSRNode::update()
     static const float minDur = 0.001f;
 
     auto cast = (tact::ASR *)sig.get();
-    auto it = cast->keys.begin();
-    it++;
-    auto &a = *(it++);
-    auto &d = *(it++);
-    auto &s = *(it++);
-    auto &r = *(it++);
+    auto &keys = cast->getKeys();
+    auto &a = keys[1];
+    auto &d = keys[2];
+    auto &s = keys[3];
+    auto &r = keys[4];
     float adsr[4];
-    adsr[0] = a.first;
-    adsr[1] = d.first - a.first;
-    adsr[2] = s.first - d.first;
-    adsr[3] = r.first - s.first;
+    adsr[0] = a.t;
+    adsr[1] = d.t - a.t;
+    adsr[2] = s.t - d.t;
+    adsr[3] = r.t - s.t;
     float amp[2];
-    amp[0] = a.second.first;
-    amp[1] = d.second.first;
+    amp[0] = a.amplitude;
+    amp[1] = d.amplitude;
     bool changed = false;
     if (ImGui::DragFloat4("Durations", adsr, 0.001f, minDur, 1, "%0.3f s"))
         changed = true;
@@ -32,26 +32,58 @@
 /// The maximum number of signals that can be played in unison (polyphony) on a single channel
 #define SYNTACTS_MAX_VOICES 8
 
+/// The maximum number of samples processed at once by block sampling functions
+/// (this also sizes the stack allocated scratch buffers used by compound Signals)
+#define SYNTACTS_BLOCK_SIZE 64
+
+/// The size in bytes of the inline buffer inside each Signal. Small Signal types
+/// (e.g. Scalar, Time, Ramp, Envelope, Pwm) are stored in place and never allocate;
+/// larger types are stored on the heap (or in the pool if SYNTACTS_USE_POOL enabled).
+/// Not used if SYNTACTS_USE_SHARED_PTR is enabled.
+#define SYNTACTS_SBO_SIZE 64
+
+/// Accuracy of the vectorized math kernels used when block sampling oscillators, decays and
+/// Programs: 0 = scalar standard library, 1 = single precision (~1e-7), 2 = double precision (~1e-15)
+#define SYNTACTS_FAST_MATH 2
+
+/// The maximum amplitude error of the lines PolyBezier::solve() approximates its curves with
+/// (curves are subdivided until they are within tolerance, so flat curves need few lines)
+#define SYNTACTS_BEZIER_TOLERANCE 1e-5
+
 /// If uncommented, Signals will use a fixed size memory pool for allocation.
 /// At this time, there doesn't seem to a great deal of benifit from doing this,
 /// but one day it may be be possible to reap the benifits of 
 /// cache coherence by using a more efficient pool scheme.
 // #define SYNTACTS_USE_POOL   
 
-/// The size of pool memory blocks in bytes available to store Signals 
-/// (only relevant if SYNTACTS_USE_POOL enabled)
-// #define SYNTACTS_POOL_BLOCK_SIZE  64
+/// The size of pool memory blocks in bytes available to store Signals. It must hold
+/// the largest Signal Model, which Signal.cpp checks for the built-in Signal types in
+/// every build (only relevant if SYNTACTS_USE_POOL enabled)
+#ifndef SYNTACTS_POOL_BLOCK_SIZE
+#define SYNTACTS_POOL_BLOCK_SIZE  256
+#endif
 
 /// The number of pool blocks, effectively maximum number of signals that can
 /// simultaneously exist (only relevant if SYNTACTS_USE_POOL enabled)
-// #define SYNTACTS_POOL_MAX_BLOCKS 1024
+#ifndef SYNTACTS_POOL_MAX_BLOCKS
+#define SYNTACTS_POOL_MAX_BLOCKS 1024
+#endif
 
-/// If uncommented, Signals will use shared pointers internally instead of unique pointers.
-/// This will result in fewer copies and allocations, but can lead to thread safety issues
-/// if you modify the parametes of Signals after they have been passed to a Session. This
-/// effectively breaks the GUI as it is currently implemented, so be warned!
+/// If uncommented, Signals will use immutable, reference counted nodes instead of unique 
+/// pointers. Copying a Signal (e.g. passing it to a Session or Spatializer) then costs a 
+/// single atomic increment instead of a deep copy of the whole graph. Non-const get() and
+/// getAs() copy a node before returning it if it is shared (copy-on-write), so re-acquire
+/// pointers rather than holding on to them across copies of the Signal.
 // #define SYNTACTS_USE_SHARED_PTR 
 
+/// If uncommented, rendering runs in single precision where double isn't needed, doubling the
+/// samples processed per vector instruction (8 lanes with AVX2, 16 with AVX-512; see the
+/// SYNTACTS_USE_NATIVE_ARCH CMake option). Sessions mix voices, ramp pitch and volume, and
+/// meter levels in float, and the sin, cos and exp block kernels used by oscillators, decays,
+/// Expressions and Programs evaluate their polynomials in float (~1e-7). Time and phase are
+/// still accumulated and range reduced in double, since they need it for long playback.
+// #define SYNTACTS_USE_FLOAT
+
 #ifndef SYNTACTS_STATIC
     #ifdef SYNTACTS_EXPORTS
         #define SYNTACTS_API __declspec(dllexport)
@@ -26,6 +26,7 @@
 
 #include <Tact/Serialization.hpp>
 #include <memory>
+#include <typeinfo>
 
 #define TACT_CURVE(T) struct T { \
                           double operator()(double t) const; \
@@ -57,6 +58,9 @@ public:
     double operator()(double a, double b, double t) const;
     /// Returns curve name
     const char* name() const;    
+    /// Returns true if the Curve is of type T
+    template <typename T>
+    bool isType() const { return m_ptr && typeid(*m_ptr) == typeid(Model<T>); }
 public:
     struct Concept {
         Concept() = default;
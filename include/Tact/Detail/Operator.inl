@@ -5,6 +5,8 @@ namespace tact
 
 inline Signal operator+(Signal lhs, Signal rhs)
 {
+    if (lhs.isType<Sum>() || lhs.isType<Mix>() || rhs.isType<Sum>() || rhs.isType<Mix>())
+        return Mix({std::move(lhs), std::move(rhs)});
     return Sum(std::move(lhs), std::move(rhs));
 }
 
@@ -29,7 +31,7 @@ inline Signal &operator+=(Signal &lhs, double rhs)
 inline Signal operator-(Signal lhs, Signal rhs)
 {
     rhs *= -1;
-    return Sum(std::move(lhs), std::move(rhs));
+    return std::move(lhs) + std::move(rhs);
 }
 
 inline Signal operator-(double lhs, Signal rhs)
@@ -56,6 +58,9 @@ inline Signal operator-(Signal lhs)
 
 inline Signal operator*(Signal lhs, Signal rhs)
 {
+    if (((lhs.isType<Product>() || lhs.isType<Modulation>()) && lhs.bias == 0) ||
+        ((rhs.isType<Product>() || rhs.isType<Modulation>()) && rhs.bias == 0))
+        return Modulation({std::move(lhs), std::move(rhs)});
     return Product(std::move(lhs), std::move(rhs));
 }
 
@@ -6,6 +6,10 @@ double IOscillator::length() const {
     return INF;
 }
 
+bool IOscillator::isConstant() const {
+    return x.isConstant();
+}
+
 inline double Sine::sample(double t) const {
     return std::sin(x.sample(t));
 }
@@ -15,18 +19,23 @@ inline double Square::sample(double t) const {
 }
 
 inline double Saw::sample(double t) const {
-    return -2 * INV_PI * std::atan(std::cos(0.5 * x.sample(t)) / std::sin(0.5 * x.sample(t)));
+    double p = 0.5 * x.sample(t);
+    return -2 * INV_PI * std::atan(std::cos(p) / std::sin(p));
 }
 
 inline double Triangle::sample(double t) const {
     return 2 * INV_PI * std::asin(std::sin(x.sample(t)));
 }
 
-
 inline double Pwm::sample(double t) const {
     return std::fmod(t, 1.0 / frequency) * frequency < dutyCycle ? 1.0 : -1.0;
 }
 
+inline void Pwm::sample(const double* t, double* b, int n) const {
+    for (int i = 0; i < n; ++i)
+        b[i] = sample(t[i]);
+}
+
 inline double Pwm::length() const {
     return INF;
 }
@@ -1,32 +1,45 @@
 #include <Tact/Signal.hpp>
+#include <type_traits>
+#include <utility>
 
 namespace tact
 {
 
+/// Detects if T implements its own block sampling function.
+template <typename T, typename = void>
+struct HasBlockSample : std::false_type {};
+
+template <typename T>
+struct HasBlockSample<T, std::void_t<decltype(std::declval<const T&>().sample(std::declval<const double*>(), std::declval<double*>(), 0))>> : std::true_type {};
+
+/// Detects if T can report that it is constant.
+template <typename T, typename = void>
+struct HasIsConstant : std::false_type {};
+
+template <typename T>
+struct HasIsConstant<T, std::void_t<decltype(std::declval<const T&>().isConstant())>> : std::true_type {};
+
+/// Detects if T can report its support.
+template <typename T, typename = void>
+struct HasSupport : std::false_type {};
+
+template <typename T>
+struct HasSupport<T, std::void_t<decltype(std::declval<const T&>().support())>> : std::true_type {};
+
 template <typename T>
 Signal::Signal(T signal) : 
     gain(1), 
     bias(0), 
-#ifndef SYNTACTS_USE_POOL
-#ifdef SYNTACTS_USE_SHARED_PTR
+#ifndef SYNTACTS_USE_SHARED_PTR
+    m_ptr(Model<T>::create(m_buffer, std::move(signal)))
+#elif !defined SYNTACTS_USE_POOL
     m_ptr(std::make_shared<Model<T>>(std::move(signal)))
 #else
-    m_ptr(std::make_unique<Model<T>>(std::move(signal)))
-#endif
-#else
-#ifdef SYNTACTS_USE_SHARED_PTR
     m_ptr(std::allocate_shared<Model<T>, Allocator<Concept>>(Allocator<Concept>(), std::move(signal)))
-#else
-    m_ptr(new (Signal::pool().allocate()) Model<T>(std::move(signal)))
-#endif
 #endif
 {
-#ifdef SYNTACTS_USE_POOL
-#ifdef SYNTACTS_USE_SHARED_PTR
+#if defined SYNTACTS_USE_POOL && defined SYNTACTS_USE_SHARED_PTR
     static_assert((2 * sizeof(void *) + sizeof(Model<T>)) <= SYNTACTS_POOL_BLOCK_SIZE, "Signal allocation would exceed SIGNAL_BLOCK SIZE");
-#else
-    static_assert((sizeof(Model<T>)) <= SYNTACTS_POOL_BLOCK_SIZE, "Signal allocation would exceed SIGNAL_BLOCK SIZE");
-#endif
 #endif
 }
 
@@ -45,14 +58,28 @@ inline double Signal::length() const
     return m_ptr->length();
 }
 
+inline bool Signal::isConstant() const
+{
+    return gain == 0 || m_ptr->isConstant();
+}
+
+inline Interval Signal::support() const
+{
+    return gain == 0 ? Interval{INF, -INF} : m_ptr->support();
+}
+
 template <typename T>
 inline bool Signal::isType() const
 { 
     return m_ptr->typeId() == typeid(T); 
 }
 
-template <typename T> inline T* Signal::getAs() const {
-    return static_cast<T*>(m_ptr->get());
+template <typename T> inline T* Signal::getAs() {
+    return static_cast<T*>(get());
+}
+
+template <typename T> inline const T* Signal::getAs() const {
+    return static_cast<const T*>(get());
 }
 
 #ifdef SYNTACTS_USE_POOL
@@ -68,6 +95,47 @@ inline int Signal::count() {
 
 ///////////////////////////////////////////////////////////////////////////////
 
+inline double Signal::Concept::length() const
+{
+    if (!(m_flags.load(std::memory_order_acquire) & Valid))
+        update();
+    return m_length.load(std::memory_order_relaxed);
+}
+
+inline bool Signal::Concept::isConstant() const
+{
+    int flags = m_flags.load(std::memory_order_acquire);
+    if (!(flags & Valid))
+        flags = update();
+    return flags & Constant;
+}
+
+inline Interval Signal::Concept::support() const
+{
+    if (!(m_flags.load(std::memory_order_acquire) & Valid))
+        update();
+    return {m_start.load(std::memory_order_relaxed), m_end.load(std::memory_order_relaxed)};
+}
+
+inline void Signal::Concept::invalidate() const
+{
+    m_flags.store(0, std::memory_order_relaxed);
+}
+
+inline int Signal::Concept::update() const
+{
+    // computing is idempotent, so racing threads will store the same values
+    int flags = Valid | (computeConstant() ? Constant : 0);
+    Interval support = computeSupport();
+    m_length.store(computeLength(), std::memory_order_relaxed);
+    m_start.store(support.start, std::memory_order_relaxed);
+    m_end.store(support.end, std::memory_order_relaxed);
+    m_flags.store(flags, std::memory_order_release);
+    return flags;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
 template <typename T>
 Signal::Model<T>::Model() 
 {} 
@@ -86,16 +154,43 @@ double Signal::Model<T>::sample(double t) const
 template <typename T>
 void Signal::Model<T>::sample(const double* t, double* b, int n, double s, double o) const 
 { 
-    for (int i = 0; i < n; ++i) 
-        b[i] = m_model.sample(t[i]) * s + o;
+    if constexpr (HasBlockSample<T>::value) {
+        m_model.sample(t, b, n);
+        if (s != 1 || o != 0) {
+            for (int i = 0; i < n; ++i)
+                b[i] = b[i] * s + o;
+        }
+    }
+    else {
+        for (int i = 0; i < n; ++i) 
+            b[i] = m_model.sample(t[i]) * s + o;
+    }
 }
 
 template <typename T>
-double Signal::Model<T>::length() const
+double Signal::Model<T>::computeLength() const
 { 
     return m_model.length(); 
 }
 
+template <typename T>
+bool Signal::Model<T>::computeConstant() const
+{ 
+    if constexpr (HasIsConstant<T>::value)
+        return m_model.isConstant();
+    else
+        return false;
+}
+
+template <typename T>
+Interval Signal::Model<T>::computeSupport() const
+{ 
+    if constexpr (HasSupport<T>::value)
+        return m_model.support();
+    else
+        return {-INF, INF};
+}
+
 template <typename T>
 std::type_index Signal::Model<T>::typeId() const
 { 
@@ -109,43 +204,76 @@ void* Signal::Model<T>::get() const
     return (void*)&m_model; 
 }
 
-#ifndef SYNTACTS_USE_SHARED_PTR
-#ifndef SYNTACTS_USE_POOL
+#ifdef SYNTACTS_USE_SHARED_PTR
 
 template <typename T>
-std::unique_ptr<Signal::Concept> Signal::Model<T>::copy() const 
-{ 
-    s_count++;
-    return std::make_unique<Signal::Model<T>>(*this); 
+std::shared_ptr<const Signal::Concept> Signal::Model<T>::copy() const
+{
+#ifdef SYNTACTS_USE_POOL
+    return std::allocate_shared<Model<T>, Allocator<Concept>>(Allocator<Concept>(), *this);
+#else
+    return std::make_shared<Model<T>>(*this);
+#endif
 }
 
 #else
 
 template <typename T>
-std::unique_ptr<Signal::Concept, Signal::Deleter> Signal::Model<T>::copy() const
+Signal::Concept* Signal::Model<T>::copy(void* buffer) const 
+{ 
+    return create(buffer, *this);
+}
+
+template <typename T>
+Signal::Concept* Signal::Model<T>::move(void* buffer)
 { 
-    s_count++;
-    return std::unique_ptr<Signal::Concept, Signal::Deleter>(new (Signal::pool().allocate()) Model(*this)); 
+    return create(buffer, std::move(*this));
 }
 
+template <typename T>
+template <typename... Args>
+Signal::Concept* Signal::Model<T>::create(void* buffer, Args&&... args)
+{
+    if constexpr (isInline()) {
+        return new (buffer) Model(std::forward<Args>(args)...);
+    }
+    else {
+#ifdef SYNTACTS_USE_POOL
+        static_assert((sizeof(Model)) <= SYNTACTS_POOL_BLOCK_SIZE, "Signal allocation would exceed SIGNAL_BLOCK SIZE");
+        return new (Signal::pool().allocate()) Model(std::forward<Args>(args)...);
+#else
+        return new Model(std::forward<Args>(args)...);
 #endif
+    }
+}
+
 #endif
 
 ///////////////////////////////////////////////////////////////////////////////
 
 template <class Archive>
 void Signal::save(Archive& archive) const {
+#ifdef SYNTACTS_USE_SHARED_PTR
     archive(TACT_MEMBER(gain), TACT_MEMBER(bias), TACT_MEMBER(m_ptr));
+#else
+    std::unique_ptr<Concept, NoDelete> ptr(m_ptr);
+    archive(TACT_MEMBER(gain), TACT_MEMBER(bias), ::cereal::make_nvp("m_ptr", ptr));
+#endif
 }
 
 template <class Archive>
 void Signal::load(Archive& archive) {
-#if defined SYNTACTS_USE_POOL && !defined SYNTACTS_USE_SHARED_PTR
-    std::unique_ptr<Concept> ptr;
-    archive(TACT_MEMBER(gain), TACT_MEMBER(bias), TACT_MEMBER(ptr));
-    m_ptr = ptr->copy();
-#else
+#ifdef SYNTACTS_USE_SHARED_PTR
     archive(TACT_MEMBER(gain), TACT_MEMBER(bias), TACT_MEMBER(m_ptr));
+    // copying a LegacyModel slices it to a plain Model
+    if (dynamic_cast<const Legacy*>(m_ptr.get()))
+        m_ptr = m_ptr->copy();
+#else
+    std::unique_ptr<Concept> ptr;
+    archive(TACT_MEMBER(gain), TACT_MEMBER(bias), ::cereal::make_nvp("m_ptr", ptr));
+    destroy();
+    // moving a LegacyModel slices it to a plain Model
+    m_ptr = ptr->move(m_buffer);
 #endif
 }
 
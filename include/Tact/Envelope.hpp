@@ -27,8 +27,8 @@
 #include <Tact/Curve.hpp>
 #include <Tact/Oscillator.hpp>
 #include <Tact/Signal.hpp>
-#include <map>
 #include <utility>
+#include <vector>
 
 namespace tact
 {
@@ -41,7 +41,9 @@ class SYNTACTS_API Envelope
 public:
     Envelope(double duration = 0.1, double amplitude = 1.0);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    Interval support() const;
 
 public:
     double duration;
@@ -56,17 +58,66 @@ private:
 /// Envelope with time sequenced amplitudes and curves.
 class SYNTACTS_API KeyedEnvelope
 {
+public:
+    /// An amplitude at a point in time.
+    struct Key {
+        double t;         ///< time in seconds
+        double amplitude; ///< amplitude at time t
+        Curve  curve;     ///< interpolates to amplitude from the previous Key
+    private:
+        friend class cereal::access;
+        template <class Archive>
+        void save(Archive& archive) const {
+            archive(cereal::make_nvp("key", t), cereal::make_nvp("value", std::make_pair(amplitude, curve)));
+        }
+        template <class Archive>
+        void load(Archive& archive) {
+            std::pair<double, Curve> value;
+            archive(cereal::make_nvp("key", t), cereal::make_nvp("value", value));
+            amplitude = value.first;
+            curve     = value.second;
+        }
+    };
 public:
     /// Constucts Envelope with initial amplitude
     KeyedEnvelope(double amplitude0 = 0.0);
-    /// Adds a new amplitude at time t seconds. Uses curve to interpolate from previous amplitude.
+    /// Adds a new amplitude at time t seconds, replacing any Key at t. Uses curve to interpolate from previous amplitude.
     void addKey(double t, double amplitude, Curve curve = Curves::Linear());
+    /// Removes all Keys.
+    void clearKeys();
+    /// Returns the Keys, sorted by time.
+    const std::vector<Key>& getKeys() const;
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
-public:
-    std::map<double, std::pair<double, Curve>> keys; ///< keys
+    Interval support() const;
+private:
+    /// The precomputed segment ending at a Key.
+    struct Segment {
+        double t0, t1;  ///< start and end time
+        double a0, a1;  ///< start and end amplitude
+        double scale;   ///< 1 / (t1 - t0)
+        bool linear;    ///< true if the curve is Linear
+    };
+    /// Recomputes segments from keys.
+    void update();
+    /// Returns the index of the first segment ending at or after t.
+    std::size_t find(double t) const;
+    /// Evaluates segment i at t within it.
+    double evaluate(std::size_t i, double t) const;
+    std::vector<Key> m_keys;         ///< keys sorted by time
+    std::vector<Segment> m_segments; ///< segment i ends at key i
 private:
-    TACT_SERIALIZE(TACT_MEMBER(keys));
+    friend class cereal::access;
+    template <class Archive>
+    void save(Archive& archive) const {
+        archive(cereal::make_nvp("keys", m_keys));
+    }
+    template <class Archive>
+    void load(Archive& archive) {
+        archive(cereal::make_nvp("keys", m_keys));
+        update();
+    }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -110,6 +161,7 @@ public:
     /// Default constructor
     ExponentialDecay(double amplitude = 1, double decay = 6.907755);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
 public:
     double amplitude;
@@ -128,7 +180,9 @@ public:
     SignalEnvelope(Signal signal = Sine(), double duration = 1.0,
                    double amplitude = 1.0);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    Interval support() const;
 
 public:
     Signal signal;
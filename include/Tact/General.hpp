@@ -27,6 +27,7 @@
 #include <Tact/Serialization.hpp>
 #include <Tact/Util.hpp>
 #include <memory>
+#include <cstdint>
 #include <string>
 #include <random>
 #include <map>
@@ -37,9 +38,21 @@ namespace tact
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// Interpolation used by Signals which read between tabulated values. Values are serialized,
+/// so new modes must be appended.
+enum class Interpolation { 
+    Linear,  ///< straight line between neighboring values
+    Cubic,   ///< Catmull-Rom spline through four neighboring values
+    Nearest, ///< hold the previous value
+    Sinc     ///< 16 tap windowed sinc (band limited resampling of recordings)
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 /// A signal that simple returns the time passed to it.
 struct Time {
     inline double sample(double t) const { return t; };
+    inline void sample(const double* t, double* b, int n) const { for (int i = 0; i < n; ++i) b[i] = t[i]; }
     constexpr double length() const { return INF; }
 private:
     TACT_SERIALIZABLE
@@ -53,7 +66,9 @@ class SYNTACTS_API Scalar
 public:
     Scalar(double value = 1);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    bool isConstant() const;
 public:
     double value;
 private:
@@ -69,7 +84,9 @@ public:
     Ramp(double initial = 1, double rate = 0);
     Ramp(double initial, double final, double duration);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    bool isConstant() const;
 public:
     double initial;
     double rate;
@@ -80,33 +97,51 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
-/// A signal that generates white noise.
+/// A signal that generates noise. Each sample is a hash of its time and the seed, so Noise 
+/// has no mutable state: it is thread-safe, and the same seed always renders the same noise.
 class SYNTACTS_API Noise
 {
 public:
-    Noise();
+    /// Noise distributions and spectra.
+    enum class Type {
+        Uniform,  ///< white noise uniformly distributed in [-1,1]
+        Gaussian, ///< white noise normally distributed with a standard deviation of 1/3
+        Pink      ///< pink (1/f) noise in [-1,1]
+    };
+    /// Constructs Noise with a unique seed.
+    Noise(Type type = Type::Uniform);
+    /// Constructs Noise with a specific seed.
+    Noise(Type type, std::uint64_t seed);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+public:
+    Type type;          ///< the distribution or spectrum
+    std::uint64_t seed; ///< the seed hashed with time
 private:
-    TACT_SERIALIZABLE
+    TACT_SERIALIZE(TACT_MEMBER(type), TACT_MEMBER(seed));
+    // Noise was archived without members, and loads as default constructed uniform noise
+    template <typename> friend struct LegacyFormat;
+    template <class Archive>
+    void loadLegacy(Archive&) { *this = Noise(); }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
-/// A signal that returns the evaluation of an expression f(t).
+/// A signal that returns the evaluation of an expression f(t). Compiled expressions are cached
+/// process-wide by string and shared between copies, so copying an Expression is cheap.
 class SYNTACTS_API Expression {
 public:
     Expression(const std::string& expr = "sin(2*pi*100*t)");
-    Expression(const Expression& other);
-    ~Expression();
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
     bool setExpression(const std::string& expr);
     const std::string& getExpression() const;
     bool operator=(const std::string& expr);
 private:
     class Impl;
-    std::unique_ptr<Impl> m_impl;
+    std::shared_ptr<const Impl> m_impl; ///< immutable compiled expression
 private:
     friend class cereal::access;
     template<class Archive>
@@ -142,11 +177,14 @@ public:
     };
 public:
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    Interval support() const;
+    /// Tessellates points into solution to within SYNTACTS_BEZIER_TOLERANCE (call after modifying points)
     void solve();
 public:
-    std::vector<PointGroup> points;
-    std::vector<Point> solution;
+    std::vector<PointGroup> points; ///< curve points, sorted by time
+    std::vector<Point> solution;    ///< piecewise linear approximation of points, sorted by time
 private:
     friend class cereal::access;
     template<class Archive>
@@ -165,20 +203,33 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 /// A Signal defined by an array of recorded samples (used internally for Library::importSignal).
+/// Times between samples are read according to interpolation, so recordings can be played back
+/// at any sample rate or pitch. Samples outside of the recording read as zero.
 class SYNTACTS_API Samples {
 public:
     Samples();
     Samples(const std::vector<float>& samples, double sampleRate);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    Interval support() const;
     int sampleCount() const;
     double sampleRate() const;
     double getSample(int i) const;
+public:
+    Interpolation interpolation = Interpolation::Linear; ///< how to read between samples
 private:
     double m_sampleRate;
     std::shared_ptr<const std::vector<float>> m_samples;
 private:
-    TACT_SERIALIZE(TACT_MEMBER(m_sampleRate), TACT_MEMBER(m_samples));
+    TACT_SERIALIZE(TACT_MEMBER(m_sampleRate), TACT_MEMBER(m_samples), TACT_MEMBER(interpolation));
+    // Samples were archived without interpolation, and always read the nearest sample
+    template <typename> friend struct LegacyFormat;
+    template <class Archive>
+    void loadLegacy(Archive& archive) {
+        archive(TACT_MEMBER(m_sampleRate), TACT_MEMBER(m_samples));
+        interpolation = Interpolation::Nearest;
+    }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
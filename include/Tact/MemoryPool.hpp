@@ -169,20 +169,21 @@ private:
 ///////////////////////////////////////////////////////////////////////////////
 
 /// A StackPool where memory management is only available to Friend
-// template <size_t BlockSize, size_t BlockCount, class Friend>
-// class FriendlyStackPool : public StackPool<BlockSize, BlockCount> {
-// public:
-//   using StackPool::blocksAvailable;
-//   using StackPool::blocksTotal;
-//   using StackPool::blocksUsed;
-//   using StackPool::StackPool;
-
-// protected:
-//   friend Friend;
-//   using StackPool::allocate;
-//   using StackPool::deallocate;
-//   using StackPool::reset;
-// };
+template <std::size_t BlockSize, std::size_t BlockCount, class Friend>
+class FriendlyStackPool : public StackPool<BlockSize, BlockCount> {
+  using Base = StackPool<BlockSize, BlockCount>;
+public:
+  using Base::blocksAvailable;
+  using Base::blocksTotal;
+  using Base::blocksUsed;
+  using Base::Base;
+
+protected:
+  friend Friend;
+  using Base::allocate;
+  using Base::deallocate;
+  using Base::reset;
+};
 
 ///////////////////////////////////////////////////////////////////////////////
 
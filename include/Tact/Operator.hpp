@@ -25,6 +25,7 @@
 #pragma once
 
 #include <Tact/Signal.hpp>
+#include <vector>
 
 namespace tact {
 
@@ -46,7 +47,10 @@ private:
 struct Sum : public IOperator {
     using IOperator::IOperator;
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    bool isConstant() const;
+    Interval support() const;
 private:
     TACT_SERIALIZE(TACT_PARENT(IOperator));
 };
@@ -57,14 +61,61 @@ private:
 struct Product : public IOperator {
     using IOperator::IOperator;
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    bool isConstant() const;
+    Interval support() const;
 private:
     TACT_SERIALIZE(TACT_PARENT(IOperator));
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
-/// Multiply two Signals.
+/// A Signal which is the result of operating on any number of other Signals.
+struct INaryOperator {
+    INaryOperator() = default;
+    INaryOperator(std::vector<Signal> signals);
+public:
+    std::vector<Signal> signals;
+private:
+    TACT_SERIALIZE(TACT_MEMBER(signals));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A Signal which is the sum of any number of other Signals. Nested Sums and Mixes
+/// are absorbed on construction, so that long chains of additions stay one level deep.
+struct Mix : public INaryOperator {
+    Mix() = default;
+    Mix(std::vector<Signal> signals);
+    double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
+    double length() const;
+    bool isConstant() const;
+    Interval support() const;
+private:
+    TACT_SERIALIZE(TACT_PARENT(INaryOperator));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A Signal which is the product of any number of other Signals. Nested Products and 
+/// Modulations without bias are absorbed on construction.
+struct Modulation : public INaryOperator {
+    Modulation() = default;
+    Modulation(std::vector<Signal> signals);
+    double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
+    double length() const;
+    bool isConstant() const;
+    Interval support() const;
+private:
+    TACT_SERIALIZE(TACT_PARENT(INaryOperator));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Multiply two Signals. Returns a Modulation if either is already a product, otherwise a Product.
 inline Signal operator*(Signal lhs, Signal rhs);
 /// Multiply a scalar and a Signal.
 inline Signal operator*(double lhs, Signal rhs);
@@ -73,7 +124,7 @@ inline Signal operator*(Signal lhs, double rhs);
 /// Multiply a Signal and a scalar.
 inline Signal& operator*=(Signal& lhs, double rhs);
 
-/// Add two Signals.
+/// Add two Signals. Returns a Mix if either is already a sum, otherwise a Sum.
 inline Signal operator+(Signal lhs, Signal rhs);
 /// Add a scalar and a Signal.
 inline Signal operator+(double lhs, Signal rhs);
@@ -0,0 +1,51 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+
+#pragma once
+
+#include <Tact/Signal.hpp>
+
+namespace tact
+{
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Rewrites a Signal graph into an equivalent but cheaper graph. This folds constant
+/// subgraphs, removes identity and zero terms, merges identical terms of a Sum, hoists
+/// gains out of Products, flattens nested Sums and Products (into Mixes and Modulations when
+/// they have more than two terms), fuses chains of Stretchers, Reversers and Repeaters into
+/// single TimeMaps, and lowers Expressions (see lowerExpression).
+/// The result samples the same values as the original and has the same length.
+SYNTACTS_API Signal optimize(const Signal& signal);
+
+/// If signal is an Expression built only from t, constants, + - * /, small integer powers, 
+/// sin and cos, returns the equivalent native graph of Time, Scalar, Sum, Product, Mix, 
+/// Modulation and Sine nodes, which benefits from native fast paths. Otherwise, returns 
+/// signal unchanged.
+SYNTACTS_API Signal lowerExpression(const Signal& signal);
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace tact
@@ -47,8 +47,16 @@ public:
     IOscillator(double hertz, Signal modulation, double index = 2.0);
     /// Returns infinity
     inline double length() const;
+    /// Returns true if the input is constant
+    inline bool isConstant() const;
 public:
     Signal x; ///< the Oscillator's input.    
+protected:
+    /// Wave shapes with dedicated phase kernels.
+    enum class Shape { Sine, Square, Saw, Triangle };
+    /// Block samples a wave shape with an incremental phase recurrence if x is a linear (pure tone) 
+    /// or quadratic (chirp) function of time and t is uniformly spaced. Returns false otherwise.
+    bool sampleKernel(Shape shape, const double* t, double* b, int n) const;
 private:
     TACT_SERIALIZE(TACT_MEMBER(x));
 };
@@ -61,6 +69,7 @@ class SYNTACTS_API Sine : public IOscillator
 public:
     using IOscillator::IOscillator;
     inline double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
 private:
     TACT_SERIALIZE(TACT_PARENT(IOscillator));
 };
@@ -73,6 +82,7 @@ class SYNTACTS_API Square : public IOscillator
 public:
     using IOscillator::IOscillator;
     inline double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
 private:
     TACT_SERIALIZE(TACT_PARENT(IOscillator));
 };
@@ -85,6 +95,7 @@ class SYNTACTS_API Saw : public IOscillator
 public:
     using IOscillator::IOscillator;
     inline double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
 private:
     TACT_SERIALIZE(TACT_PARENT(IOscillator));
 };
@@ -97,12 +108,90 @@ class SYNTACTS_API Triangle : public IOscillator
 public:
     using IOscillator::IOscillator;
     inline double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
 private:
     TACT_SERIALIZE(TACT_PARENT(IOscillator));
 };
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// Interface class for Oscillators which read one period of their waveform from precomputed
+/// tables shared by the whole process. Much cheaper than the exact Oscillators. Nearest reads 
+/// as Linear and Sinc as Cubic.
+class SYNTACTS_API IWavetable : public IOscillator
+{
+public:
+    using IOscillator::IOscillator;
+public:
+    Interpolation interpolation = Interpolation::Linear; ///< how to read between table entries
+protected:
+    /// Reads tables at phase x(t). Table k of levels holds the waveform band-limited to 
+    /// harmonic 2^k, and scalar reads, which don't know the sample rate, use the last one.
+    double lookup(const float* const* tables, int levels, double t) const;
+    /// Reads tables at phases x(t) for n times, using the table with the most harmonics 
+    /// below Nyquist for the largest phase increment between consecutive times.
+    void lookup(const float* const* tables, int levels, const double* t, double* b, int n) const;
+private:
+    TACT_SERIALIZE(TACT_PARENT(IOscillator), TACT_MEMBER(interpolation));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A sine wave Oscillator evaluated by table lookup, accurate to about 3e-7 (Linear) or 1e-7 (Cubic).
+class SYNTACTS_API WavetableSine : public IWavetable
+{
+public:
+    using IWavetable::IWavetable;
+    double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
+private:
+    TACT_SERIALIZE(TACT_PARENT(IWavetable));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A square wave Oscillator evaluated by lookup of band-limited tables, so that it doesn't alias.
+/// Like any band-limited square, it rings next to its edges, overshooting to about 1.18.
+class SYNTACTS_API WavetableSquare : public IWavetable
+{
+public:
+    using IWavetable::IWavetable;
+    double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
+private:
+    TACT_SERIALIZE(TACT_PARENT(IWavetable));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A saw wave Oscillator evaluated by lookup of band-limited tables, so that it doesn't alias.
+/// Like any band-limited saw, it rings next to its edge, overshooting to about 1.18.
+class SYNTACTS_API WavetableSaw : public IWavetable
+{
+public:
+    using IWavetable::IWavetable;
+    double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
+private:
+    TACT_SERIALIZE(TACT_PARENT(IWavetable));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A triangle wave Oscillator evaluated by lookup of band-limited tables, so that it doesn't alias
+/// (its corners are rounded to the harmonics the sample rate allows).
+class SYNTACTS_API WavetableTriangle : public IWavetable
+{
+public:
+    using IWavetable::IWavetable;
+    double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
+private:
+    TACT_SERIALIZE(TACT_PARENT(IWavetable));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 /// A PWM square wave with adjustable frequency and duty cycle.
 class SYNTACTS_API Pwm
 {
@@ -110,6 +199,7 @@ public:
     /// Constructor
     Pwm(double frequency = 1.0, double dutyCycle = 0.5);
     inline double sample(double t) const;
+    inline void sample(const double* t, double* b, int n) const;
     inline double length() const;
 public:
     double frequency;
@@ -0,0 +1,84 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+
+#pragma once
+
+#include <Tact/Signal.hpp>
+#include <ostream>
+#include <string>
+
+namespace tact
+{
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A Signal which samples a function from a compiled shared library, usually a 
+/// translation unit generated with tact::codegen and built into a .dll/.so/.dylib.
+class SYNTACTS_API Plugin
+{
+public:
+    /// Default constructor (an unopened Plugin which returns zero).
+    Plugin();
+    /// Constructs a Plugin and opens the shared library at path.
+    Plugin(const std::string& path);
+    /// Opens the shared library at path. Returns false if it could not be opened.
+    bool open(const std::string& path);
+    /// Returns true if a shared library is open.
+    bool isOpen() const;
+    /// Returns the path of the shared library.
+    const std::string& getPath() const;
+    double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
+    double length() const;
+private:
+    struct Library;
+    std::shared_ptr<const Library> m_lib;
+    std::string m_path;
+private:
+    friend class cereal::access;
+    template<class Archive>
+    void save(Archive& archive) const 
+    { 
+        archive(TACT_MEMBER(m_path)); 
+    }
+    template<class Archive>
+    void load(Archive& archive) 
+    { 
+        std::string path;
+        archive(cereal::make_nvp("m_path", path)); 
+        open(path); 
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Writes a self-contained C++ translation unit to out which implements signal as a 
+/// single flat function with all constants inlined. Build it as a shared library and 
+/// open it with Plugin. Returns false if signal contains a type which can't be generated.
+SYNTACTS_API bool codegen(const Signal& signal, std::ostream& out);
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace tact
@@ -25,6 +25,8 @@
 #pragma once
 
 #include <Tact/Signal.hpp>
+#include <Tact/Util.hpp>
+#include <vector>
 
 namespace tact
 {
@@ -38,6 +40,7 @@ public:
     Repeater();
     Repeater(Signal signal, int repetitions, double delay = 0);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
 
 public:
@@ -58,7 +61,9 @@ public:
     Stretcher();
     Stretcher(Signal signal, double factor);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    bool isConstant() const;
 
 public:
     Signal signal;
@@ -76,7 +81,9 @@ public:
     Reverser();
     Reverser(Signal signal);
     double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
     double length() const;
+    bool isConstant() const;
 public:
     Signal signal;
 private:
@@ -85,4 +92,38 @@ private:
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// A Signal which samples another Signal through a chain of time transforms, evaluated in a
+/// single pass. optimize() fuses nested Stretchers, Reversers and Repeaters into TimeMaps.
+class SYNTACTS_API TimeMap {
+public:
+    /// A time transform. Affine stages map t to clamp(scale * t + offset, lo, hi). Periodic
+    /// stages zero the output if t > end, and otherwise map t to fmod(t, period), zeroing the
+    /// output if that is greater than active.
+    struct Stage {
+        bool   periodic = false;
+        double scale = 1, offset = 0, lo = -INF, hi = INF;
+        double period = INF, active = INF, end = INF;
+        /// Makes an affine Stage.
+        static Stage affine(double scale, double offset, double lo = -INF, double hi = INF);
+        /// Makes a periodic Stage.
+        static Stage repeat(double period, double active, double end);
+        TACT_SERIALIZE(TACT_MEMBER(periodic), TACT_MEMBER(scale), TACT_MEMBER(offset), TACT_MEMBER(lo), 
+                       TACT_MEMBER(hi), TACT_MEMBER(period), TACT_MEMBER(active), TACT_MEMBER(end));
+    };
+public:
+    TimeMap();
+    double sample(double t) const;
+    void sample(const double* t, double* b, int n) const;
+    double length() const;
+    bool isConstant() const;
+public:
+    Signal signal;             ///< the transformed Signal
+    std::vector<Stage> stages; ///< applied in order to the input time
+    double duration;           ///< length of the TimeMap
+private:
+    TACT_SERIALIZE(TACT_MEMBER(signal), TACT_MEMBER(stages), TACT_MEMBER(duration));
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 } // namespace tact
\ No newline at end of file
@@ -0,0 +1,127 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+
+#pragma once
+
+#include <Tact/Signal.hpp>
+#include <Tact/Envelope.hpp>
+#include <vector>
+
+namespace tact
+{
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A Signal graph lowered to a flat list of register based instructions (see tact::compile).
+/// Each instruction is evaluated over an entire block of samples at a time, so the cost of
+/// walking the graph is paid once per block instead of once per sample. Structurally 
+/// identical subgraphs (e.g. a modulator used in many branches) are evaluated only once.
+class SYNTACTS_API Program
+{
+public:
+    /// Instruction operation codes.
+    enum class Op : int {
+        Const,    ///< dst = k0
+        Affine,   ///< dst = a * k0 + k1
+        Add,      ///< dst = a + b
+        Mul,      ///< dst = a * b
+        Sin,      ///< dst = sin(a)
+        Square,   ///< dst = sin(a) > 0 ? 1 : -1
+        Saw,      ///< dst = saw wave of phase a
+        Triangle, ///< dst = triangle wave of phase a
+        Pwm,      ///< dst = PWM with frequency k0 and duty cycle k1 at time a
+        Envelope, ///< dst = a > k0 ? 0 : k1
+        Decay,    ///< dst = k0 * exp(-k1 * a)
+        Wrap,     ///< dst = fmod(a, k0)
+        Clamp,    ///< dst = clamp(a, k0, k1)
+        Gate,     ///< dst = k0 <= a <= k1 ? b : 0
+        Keyed,    ///< dst = keyed envelope idx sampled at times a
+        Call      ///< dst = Signal idx sampled at times a
+    };
+
+    /// A single Program instruction.
+    struct Instruction {
+        Op     op;
+        int    dst, a, b;
+        double k0, k1;
+        int    idx;
+    };
+
+    /// Default constructor (an empty Program which returns zero).
+    Program();
+    /// Samples the Program at time t in seconds.
+    double sample(double t) const;
+    /// Samples the Program at n times given by t into output buffer b.
+    void sample(const double* t, double* b, int n) const;
+    /// Returns the length of the source Signal.
+    double length() const;
+
+    /// Returns the Signal this Program was compiled from.
+    const Signal& source() const;
+    /// Returns the instructions of this Program.
+    const std::vector<Instruction>& instructions() const;
+    /// Returns the number of registers used by this Program.
+    int registerCount() const;
+
+private:
+    friend class Compiler;
+    std::vector<Instruction>   m_code;      ///< instructions
+    std::vector<KeyedEnvelope> m_envelopes; ///< keyed envelopes used by Op::Keyed
+    std::vector<Signal>        m_calls;     ///< opaque Signals used by Op::Call
+    int    m_registers;                     ///< number of registers (register 0 is time)
+    int    m_output;                        ///< output register
+    double m_length;                        ///< cached length of source
+    Signal m_source;                        ///< the original Signal (for serialization)
+private:
+    friend class cereal::access;
+    template<class Archive>
+    void save(Archive& archive) const 
+    { 
+        archive(TACT_MEMBER(m_source)); 
+    }
+    template<class Archive>
+    void load(Archive& archive);
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Compiles a Signal graph into a flat Program. Signal types without an instruction 
+/// counterpart (e.g. Sequence, Expression) are embedded and sampled through the Signal 
+/// interface. The result is itself a Signal, and can be passed to Session::play.
+SYNTACTS_API Program compile(const Signal& signal);
+
+///////////////////////////////////////////////////////////////////////////////
+
+template<class Archive>
+void Program::load(Archive& archive) 
+{ 
+    Signal source;
+    archive(cereal::make_nvp("m_source", source)); 
+    *this = compile(source);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace tact
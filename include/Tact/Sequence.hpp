@@ -25,6 +25,7 @@
 #pragma once
 
 #include <Tact/Signal.hpp>
+#include <memory>
 #include <vector>
 
 namespace tact {
@@ -35,11 +36,13 @@ namespace tact {
 class Sequence {
 public:
 
-    /// A Key in the Sequence.
+    /// A Key in the Sequence: an immutable Signal instance played at a time offset. Instances are
+    /// shared by reference, so Keys copied between Sequences never copy their Signals.
     struct Key { 
-        double t; 
-        Signal signal; 
-        TACT_SERIALIZE(TACT_MEMBER(t), TACT_MEMBER(signal));
+        double t;                             ///< time offset
+        double gain = 1;                      ///< gain applied to the instance
+        std::shared_ptr<const Signal> signal; ///< shared Signal instance
+        TACT_SERIALIZE(TACT_MEMBER(t), TACT_MEMBER(gain), TACT_MEMBER(signal));
     };
 
     /// Default constructor.
@@ -50,17 +53,25 @@ public:
     Sequence& push(Signal signal);
     /// Pushes another Sequence at the head position and then moves the head forward.
     Sequence& push(Sequence sequence);
-    /// Inserts a Signal at position t in this Sequence but does NOT move head.
+    /// Inserts a Signal at position t in this Sequence but does NOT move head. 
+    /// A Signal holding a Sequence is flattened into its Keys.
     Sequence& insert(Signal signal, double t);
     /// Inserts another Sequence at position t in this Sequence but does NOT move head.
+    /// Its Keys are flattened into this Sequence, sharing their Signal instances.
     Sequence& insert(Sequence sequence, double t);
+    /// Inserts a Key at position t + key.t in this Sequence, sharing its Signal instance, but does NOT move head.
+    Sequence& insert(const Key& key, double t = 0);
     /// Clears the Sequence
     void clear();
 
     /// Samples and sums all overlapping signals in the sequence at time t.
     double sample(double t) const;
+    /// Samples and sums all overlapping signals in the sequence at n times given by t.
+    void sample(const double* t, double* b, int n) const;
     /// Returns the length of the Sequence.
     double length() const;
+    /// Returns the interval from the start of the first Key to the end of the last Key.
+    Interval support() const;
 
     /// Returns the number of keys in the sequence.
     int keyCount() const;
@@ -77,10 +88,52 @@ public:
 public:
     double head; ///< the current insertion head position/time.
 private:
-    std::vector<Key> m_keys; ///< all keys
-    double m_length;         ///< accumulated length
+    /// The span of time a Key overlaps.
+    struct Span { 
+        double start, end, length, gain; 
+        int key; 
+    };
+    /// Adds the Span of the last Key to the index.
+    void indexLast();
+    /// Rebuilds the index from all Keys.
+    void index();
+    /// Rebuilds the tree of Span ends.
+    void buildTree();
+    /// Calls f for every Span overlapping [t0,t1], in order of start time.
+    template <typename F>
+    void overlapping(double t0, double t1, F&& f) const;
+private:
+    std::vector<Key> m_keys;     ///< all keys, in order of insertion
+    double m_length;             ///< accumulated length
+    std::vector<Span> m_spans;   ///< key spans sorted by start time
+    std::vector<double> m_tree;  ///< implicit binary tree of the maximum end of m_spans ranges
 private:
-    TACT_SERIALIZE(TACT_MEMBER(head), TACT_MEMBER(m_keys), TACT_MEMBER(m_length));
+    friend class cereal::access;
+    template <class Archive>
+    void save(Archive& archive) const {
+        archive(TACT_MEMBER(head), TACT_MEMBER(m_keys), TACT_MEMBER(m_length));
+    }
+    template <class Archive>
+    void load(Archive& archive) {
+        archive(TACT_MEMBER(head), TACT_MEMBER(m_keys), TACT_MEMBER(m_length));
+        index();
+    }
+    /// A Key as archived before Keys shared their Signals
+    struct LegacyKey {
+        double t;
+        Signal signal;
+        TACT_SERIALIZE(TACT_MEMBER(t), TACT_MEMBER(signal));
+    };
+    template <typename> friend struct LegacyFormat;
+    template <class Archive>
+    void loadLegacy(Archive& archive) {
+        std::vector<LegacyKey> keys;
+        archive(TACT_MEMBER(head), ::cereal::make_nvp("m_keys", keys), TACT_MEMBER(m_length));
+        m_keys.clear();
+        for (auto& key : keys)
+            m_keys.push_back({key.t, 1, std::make_shared<const Signal>(std::move(key.signal))});
+        index();
+    }
 };
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -47,3 +47,18 @@
 #define TACT_MEMBER(T) ::cereal::make_nvp(#T, T)
 
 ///////////////////////////////////////////////////////////////////////////////
+
+namespace tact {
+
+/// Loads value through T::loadLegacy, which reads the layout T was archived with before it
+/// last changed (see Signal::LegacyModel). Classes with a private loadLegacy befriend it.
+template <typename T>
+struct LegacyFormat {
+    T& value;
+    template <class Archive>
+    void load(Archive& archive) { value.loadLegacy(archive); }
+};
+
+} // namespace tact
+
+///////////////////////////////////////////////////////////////////////////////
@@ -169,6 +169,12 @@ public:
     /// Opens the control panel of a device if supported.
     void openControlPanel(int index);
 
+    /// Enables/disables simplifying Signals with tact::optimize before they are played (default disabled).
+    void setAutoOptimize(bool enabled);
+
+    /// Returns true if Signals are simplified with tact::optimize before they are played.
+    bool getAutoOptimize() const;
+
 public:
 
     /// Returns the number of active Sessions across the entire process.
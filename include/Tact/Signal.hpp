@@ -29,6 +29,9 @@
 #include <Tact/MemoryPool.hpp>
 #include <typeinfo>
 #include <typeindex>
+#include <new>
+#include <type_traits>
+#include <atomic>
 
 namespace tact
 {
@@ -49,15 +52,26 @@ public:
     inline void sample(const double* t, double* b, int n) const;
     /// Returns the length of the Signal in seconds or infinity.
     inline double length() const;
+    /// Returns true if the Signal has the same value at all times.
+    inline bool isConstant() const;
+    /// Returns the interval outside of which the Signal samples only its bias. Types report 
+    /// this with Interval support() const, and are otherwise assumed to be non-zero anywhere.
+    inline Interval support() const;
 
     /// Returns the type_index of the underlying type-erased Signal.
     std::type_index typeId() const;
     /// Returns true if the underlying type-erased Signal is type T.
     template <typename T> inline bool isType() const;
     /// Gets a pointer to the underlying type-erased Signal type (use with caution).
-    void* get() const;
+    /// If SYNTACTS_USE_SHARED_PTR is enabled, a shared node is first copied (copy-on-write).
+    /// The node's cached length is invalidated, so don't hold on to the pointer for later mutation.
+    void* get();
+    /// Gets a const pointer to the underlying type-erased Signal type.
+    const void* get() const;
     /// Gets a pointer to the underlying type-erased Signal, cast as type T (use with caution and only if you know the Signal is a T!).
-    template <typename T> inline T* getAs() const;
+    template <typename T> inline T* getAs();
+    /// Gets a const pointer to the underlying type-erased Signal, cast as type T.
+    template <typename T> inline const T* getAs() const;
     
     /// Returns the current count of Signals allocated in this process.
     static inline int count();
@@ -72,11 +86,13 @@ public:
     /// Copy constructor
     Signal(const Signal& other);
     /// Move constructor
-    Signal(Signal&&) noexcept = default;
+    Signal(Signal&& other) noexcept;
     /// Assignment operator
     Signal& operator=(const Signal& other);
     /// Assignment move operator
-    Signal& operator=(Signal&&) noexcept = default;
+    Signal& operator=(Signal&& other) noexcept;
+    /// Destructor
+    ~Signal();
 #endif
 
 #ifdef SYNTACTS_USE_POOL
@@ -85,59 +101,101 @@ public:
 #endif
 
 public:
-    struct Concept;
-    /// Unique Pointer Deleter
-#ifdef SYNTACTS_USE_POOL
-    struct Deleter {
-        void operator()(Concept* ptr)
-        { ptr->~Concept(); Signal::pool().deallocate(ptr); }
-    };    
-#endif
     /// Type Erasure Concept
     struct Concept {
-        Concept() { s_count++; }
+        Concept() : m_length(0), m_start(0), m_end(0), m_flags(0) { s_count++; }
+        Concept(const Concept& other) : 
+            m_length(other.m_length.load(std::memory_order_relaxed)), 
+            m_start(other.m_start.load(std::memory_order_relaxed)), 
+            m_end(other.m_end.load(std::memory_order_relaxed)), 
+            m_flags(other.m_flags.load(std::memory_order_relaxed)) 
+        { s_count++; }
         virtual ~Concept() { s_count--; }
         virtual double sample(double t) const = 0;
         virtual void sample(const double* t, double* b, int n, double s, double o) const = 0;
-        virtual double length() const = 0;
+        virtual double computeLength() const = 0;
+        virtual bool computeConstant() const = 0;
+        virtual Interval computeSupport() const = 0;
         virtual std::type_index typeId() const = 0;
         virtual void* get() const = 0;
-#ifndef SYNTACTS_USE_SHARED_PTR
-#ifdef SYNTACTS_USE_POOL
-        virtual std::unique_ptr<Concept, Deleter> copy() const = 0;
+#ifdef SYNTACTS_USE_SHARED_PTR
+        /// Copy constructs a new, unshared node
+        virtual std::shared_ptr<const Concept> copy() const = 0;
 #else
-        virtual std::unique_ptr<Concept> copy() const = 0;
-#endif
+        /// Copy constructs into buffer if small enough, otherwise into heap/pool storage
+        virtual Concept* copy(void* buffer) const = 0;
+        /// Move constructs into buffer if small enough, otherwise into heap/pool storage
+        virtual Concept* move(void* buffer) = 0;
 #endif
+        /// Returns the cached length, computing it if invalid
+        inline double length() const;
+        /// Returns the cached constant flag, computing it if invalid
+        inline bool isConstant() const;
+        /// Returns the cached support, computing it if invalid
+        inline Interval support() const;
+        /// Invalidates cached metadata (called before the model is mutated)
+        inline void invalidate() const;
         static inline int count() {return s_count; }
         template <class Archive>
         void serialize(Archive& archive) {}
     protected:
         static int s_count;
+    private:
+        enum Flags : int { Valid = 1, Constant = 2 };
+        inline int update() const;
+        mutable std::atomic<double> m_length; ///< cached length
+        mutable std::atomic<double> m_start;  ///< cached start of support
+        mutable std::atomic<double> m_end;    ///< cached end of support
+        mutable std::atomic<int>    m_flags;  ///< cached Flags (zero if invalid)
     };
     /// Type Erasure Model
     template <typename T>
-    struct Model final : Concept {
+    struct Model : Concept {
         Model();
         Model(T model);
         double sample(double t) const override;
         void sample(const double* t, double* b, int n, double s, double o) const override;
-        double length() const override;
+        double computeLength() const override;
+        bool computeConstant() const override;
+        Interval computeSupport() const override;
         std::type_index typeId() const override;
         void* get() const override;
-#ifndef SYNTACTS_USE_SHARED_PTR
-#ifdef SYNTACTS_USE_POOL
-        std::unique_ptr<Concept, Deleter> copy() const override;
+#ifdef SYNTACTS_USE_SHARED_PTR
+        std::shared_ptr<const Concept> copy() const override;
 #else
-        std::unique_ptr<Concept> copy() const override;
-#endif
+        Concept* copy(void* buffer) const override;
+        Concept* move(void* buffer) override;
+        /// Returns true if this Model is stored inside of a Signal's inline buffer
+        static constexpr bool isInline() {
+            return sizeof(Model) <= SYNTACTS_SBO_SIZE && alignof(Model) <= alignof(double) &&
+                   std::is_nothrow_move_constructible<T>::value;
+        }
+        /// Constructs a Model inside of buffer if Inline, otherwise in heap/pool storage
+        template <typename... Args> static Concept* create(void* buffer, Args&&... args);
 #endif
         T m_model;
         TACT_SERIALIZE(TACT_PARENT(Concept), TACT_MEMBER(m_model));
     };
+    /// Marks Models read from a legacy layout
+    struct Legacy { };
+    /// Model of a T read from an archive written before T's layout last changed. It is registered
+    /// under the name Model<T> was archived with (see Library.cpp), and a Signal replaces it with
+    /// a plain Model<T> as soon as it is loaded, so it is never saved.
+    template <typename T>
+    struct LegacyModel final : Model<T>, Legacy {
+        template <class Archive>
+        void serialize(Archive& archive) {
+            if constexpr (std::is_base_of<::cereal::detail::InputArchiveBase, Archive>::value)
+                archive(TACT_PARENT(Concept), ::cereal::make_nvp("m_model", LegacyFormat<T>{this->m_model}));
+            else
+                throw ::cereal::Exception("LegacyModels are never saved");
+        }
+    };
 private:
 #ifdef SYNTACTS_USE_SHARED_PTR
-    std::shared_ptr<const Concept> m_ptr;
+    /// Copies the node if it is shared with other Signals
+    void detach();
+    std::shared_ptr<const Concept> m_ptr; ///< immutable while shared
 #ifdef SYNTACTS_USE_POOL
     template<typename T>
     struct Allocator
@@ -153,11 +211,16 @@ private:
     };
 #endif
 #else
-#ifdef SYNTACTS_USE_POOL
-    std::unique_ptr<Concept, Deleter> m_ptr;
-#else
-    std::unique_ptr<Concept> m_ptr;
-#endif
+    /// Returns true if m_ptr points into m_buffer
+    bool isInline() const { return (const void*)m_ptr == (const void*)m_buffer; }
+    /// Takes ownership of other's Model, moving it if stored inline
+    void steal(Signal& other) noexcept;
+    /// Destroys and frees the Model
+    void destroy() noexcept;
+    /// Non-owning deleter used to serialize m_ptr
+    struct NoDelete { void operator()(Concept*) const { } };
+    Concept* m_ptr; ///< points into m_buffer or heap/pool storage
+    alignas(double) unsigned char m_buffer[SYNTACTS_SBO_SIZE]; ///< inline storage for small Models
 #endif
 private:
     friend class cereal::access;
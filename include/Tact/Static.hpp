@@ -0,0 +1,268 @@
+// MIT License
+//
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+//
+// Author(s): Evan Pezent (epezent@rice.edu)
+
+
+#pragma once
+
+#include <Tact/Curve.hpp>
+#include <Tact/Util.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace tact 
+{
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Statically typed Signal expressions. Composing these with operator* and operator+ 
+/// builds nested value types (e.g. Static::Product<Static::Sine<...>, Static::ASR<...>>) 
+/// whose sample functions are fully visible to the compiler, so an entire expression 
+/// inlines into a single loop with no allocations or virtual calls. They sample exactly 
+/// the same values as their dynamic counterparts, and convert to a type-erased Signal at 
+/// the boundary (e.g. Session::play). Static expressions are not serializable.
+namespace Static {
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Base of all static expressions (CRTP).
+template <typename Derived>
+struct Expr {
+    /// Returns the derived expression.
+    const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A Signal that simply returns the time passed to it.
+struct Time : Expr<Time> {
+    double sample(double t) const { return t; }
+    double length() const { return INF; }
+};
+
+/// A Signal that emits a constant value over time.
+struct Scalar : Expr<Scalar> {
+    Scalar(double value = 1) : value(value) { }
+    double sample(double) const { return value; }
+    double length() const { return INF; }
+    double value;
+};
+
+/// A Signal that increases or decreases over time.
+struct Ramp : Expr<Ramp> {
+    Ramp(double initial = 1, double rate = 0) : initial(initial), rate(rate), duration(INF) { }
+    Ramp(double initial, double final, double duration) : initial(initial), rate((final - initial) / duration), duration(duration) { }
+    double sample(double t) const { return initial + rate * t; }
+    double length() const { return duration; }
+    double initial, rate, duration;
+};
+
+/// An expression scaled by gain and offset by bias (equivalent to Signal::gain and Signal::bias).
+template <typename X>
+struct Affine : Expr<Affine<X>> {
+    Affine(X x, double gain = 1, double bias = 0) : x(std::move(x)), gain(gain), bias(bias) { }
+    double sample(double t) const { return x.sample(t) * gain + bias; }
+    double length() const { return x.length(); }
+    X x;
+    double gain, bias;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A Signal which is the sum of two other expressions.
+template <typename L, typename R>
+struct Sum : Expr<Sum<L, R>> {
+    Sum(L lhs, R rhs) : lhs(std::move(lhs)), rhs(std::move(rhs)) { }
+    double sample(double t) const { return lhs.sample(t) + rhs.sample(t); }
+    double length() const { return std::max(lhs.length(), rhs.length()); }
+    L lhs;
+    R rhs;
+};
+
+/// A Signal which is the product of two other expressions.
+template <typename L, typename R>
+struct Product : Expr<Product<L, R>> {
+    Product(L lhs, R rhs) : lhs(std::move(lhs)), rhs(std::move(rhs)) { }
+    double sample(double t) const { return lhs.sample(t) * rhs.sample(t); }
+    double length() const { return std::min(lhs.length(), rhs.length()); }
+    L lhs;
+    R rhs;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// The default oscillator input, i.e. TWO_PI * hertz * Time().
+using Phase = Affine<Time>;
+
+/// A sine wave Oscillator.
+template <typename X = Phase>
+struct Sine : Expr<Sine<X>> {
+    Sine(double hertz = 100) : x(Time(), TWO_PI * hertz) { }
+    Sine(const Expr<X>& x) : x(x.self()) { }
+    double sample(double t) const { return std::sin(x.sample(t)); }
+    double length() const { return INF; }
+    X x;
+};
+
+/// A square wave Oscillator.
+template <typename X = Phase>
+struct Square : Expr<Square<X>> {
+    Square(double hertz = 100) : x(Time(), TWO_PI * hertz) { }
+    Square(const Expr<X>& x) : x(x.self()) { }
+    double sample(double t) const { return std::sin(x.sample(t)) > 0 ? 1.0 : -1.0; }
+    double length() const { return INF; }
+    X x;
+};
+
+/// A saw wave Oscillator.
+template <typename X = Phase>
+struct Saw : Expr<Saw<X>> {
+    Saw(double hertz = 100) : x(Time(), TWO_PI * hertz) { }
+    Saw(const Expr<X>& x) : x(x.self()) { }
+    double sample(double t) const { 
+        double p = x.sample(t);
+        return -2 * INV_PI * std::atan(std::cos(0.5 * p) / std::sin(0.5 * p)); 
+    }
+    double length() const { return INF; }
+    X x;
+};
+
+/// A triangle wave Oscillator.
+template <typename X = Phase>
+struct Triangle : Expr<Triangle<X>> {
+    Triangle(double hertz = 100) : x(Time(), TWO_PI * hertz) { }
+    Triangle(const Expr<X>& x) : x(x.self()) { }
+    double sample(double t) const { return 2 * INV_PI * std::asin(std::sin(x.sample(t))); }
+    double length() const { return INF; }
+    X x;
+};
+
+/// A PWM square wave with adjustable frequency and duty cycle.
+struct Pwm : Expr<Pwm> {
+    Pwm(double frequency = 1.0, double dutyCycle = 0.5) : frequency(frequency), dutyCycle(dutyCycle) { }
+    double sample(double t) const { return std::fmod(t, 1.0 / frequency) * frequency < dutyCycle ? 1.0 : -1.0; }
+    double length() const { return INF; }
+    double frequency, dutyCycle;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// A basic envelope, providing a duration and constant amplitude.
+struct Envelope : Expr<Envelope> {
+    Envelope(double duration = 0.1, double amplitude = 1.0) : duration(duration), amplitude(amplitude) { }
+    double sample(double t) const { return t > duration ? 0.0 : amplitude; }
+    double length() const { return duration; }
+    double duration, amplitude;
+};
+
+/// Exponential decay according to the law y = A*e^(-Bt).
+struct ExponentialDecay : Expr<ExponentialDecay> {
+    ExponentialDecay(double amplitude = 1, double decay = 6.907755) : amplitude(amplitude), decay(decay) { }
+    double sample(double t) const { return amplitude * std::exp(-decay * t); }
+    double length() const { return -std::log(0.001 / amplitude) / decay; }
+    double amplitude, decay;
+};
+
+/// Attack-Sustain-Release Envelope with statically typed Curves.
+template <typename AttackCurve = Curves::Linear, typename ReleaseCurve = Curves::Linear>
+struct ASR : Expr<ASR<AttackCurve, ReleaseCurve>> {
+    ASR(double attackTime = 0.025, double sustainTime = 0.05, double releaseTime = 0.025, 
+        double attackAmplitude = 1.0, AttackCurve attackCurve = {}, ReleaseCurve releaseCurve = {}) :
+        attack(attackTime), 
+        sustain(attackTime + sustainTime), 
+        release(attackTime + sustainTime + releaseTime),
+        amplitude(attackAmplitude),
+        attackCurve(attackCurve),
+        releaseCurve(releaseCurve)
+    { }
+    double sample(double t) const {
+        // mirrors KeyedEnvelope::sample for keys at 0, attack, sustain and release
+        if (t > release || t <= 0)
+            return 0;
+        if (t < attack)
+            return lerp(0, amplitude, attackCurve(t / attack));
+        if (t <= sustain)
+            return amplitude;
+        if (t < release)
+            return lerp(amplitude, 0, releaseCurve((t - sustain) / (release - sustain)));
+        return 0;
+    }
+    double length() const { return release; }
+    double attack, sustain, release; ///< key times
+    double amplitude;
+    AttackCurve attackCurve;
+    ReleaseCurve releaseCurve;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+/// Multiply two expressions.
+template <typename L, typename R>
+inline Product<L, R> operator*(const Expr<L>& lhs, const Expr<R>& rhs) { return {lhs.self(), rhs.self()}; }
+/// Multiply a scalar and an expression.
+template <typename X>
+inline Affine<X> operator*(double lhs, const Expr<X>& rhs) { return {rhs.self(), lhs, 0}; }
+/// Multiply an expression and a scalar.
+template <typename X>
+inline Affine<X> operator*(const Expr<X>& lhs, double rhs) { return {lhs.self(), rhs, 0}; }
+/// Multiply a scaled expression and a scalar (folds into the existing gain and bias).
+template <typename X>
+inline Affine<X> operator*(double lhs, const Affine<X>& rhs) { return {rhs.x, rhs.gain * lhs, rhs.bias * lhs}; }
+/// Multiply a scaled expression and a scalar (folds into the existing gain and bias).
+template <typename X>
+inline Affine<X> operator*(const Affine<X>& lhs, double rhs) { return {lhs.x, lhs.gain * rhs, lhs.bias * rhs}; }
+
+/// Add two expressions.
+template <typename L, typename R>
+inline Sum<L, R> operator+(const Expr<L>& lhs, const Expr<R>& rhs) { return {lhs.self(), rhs.self()}; }
+/// Add a scalar and an expression.
+template <typename X>
+inline Affine<X> operator+(double lhs, const Expr<X>& rhs) { return {rhs.self(), 1, lhs}; }
+/// Add an expression and a scalar.
+template <typename X>
+inline Affine<X> operator+(const Expr<X>& lhs, double rhs) { return {lhs.self(), 1, rhs}; }
+/// Add a scaled expression and a scalar (folds into the existing bias).
+template <typename X>
+inline Affine<X> operator+(double lhs, const Affine<X>& rhs) { return {rhs.x, rhs.gain, rhs.bias + lhs}; }
+/// Add a scaled expression and a scalar (folds into the existing bias).
+template <typename X>
+inline Affine<X> operator+(const Affine<X>& lhs, double rhs) { return {lhs.x, lhs.gain, lhs.bias + rhs}; }
+
+/// Subtract two expressions.
+template <typename L, typename R>
+inline Sum<L, Affine<R>> operator-(const Expr<L>& lhs, const Expr<R>& rhs) { return {lhs.self(), -1.0 * rhs}; }
+/// Subtract a scalar from an expression.
+template <typename X>
+inline auto operator-(const Expr<X>& lhs, double rhs) { return lhs.self() + -rhs; }
+/// Subtract an expression from a scalar.
+template <typename X>
+inline auto operator-(double lhs, const Expr<X>& rhs) { return lhs + -1.0 * rhs.self(); }
+/// Negate an expression.
+template <typename X>
+inline auto operator-(const Expr<X>& rhs) { return -1.0 * rhs.self(); }
+
+///////////////////////////////////////////////////////////////////////////////
+
+} // namespace Static
+
+} // namespace tact
@@ -42,6 +42,14 @@ constexpr double EPS     = std::numeric_limits<double>::epsilon();
 
 ///////////////////////////////////////////////////////////////////////////////
 
+/// A closed interval of time in seconds, which is empty if start > end.
+struct Interval {
+    double start; ///< first time in the interval
+    double end;   ///< last time in the interval
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
 /// Clampes value between min and max
 inline double clamp(double value, double min, double max) {
     return value <= min ? min : value >= max ? max : value;
@@ -0,0 +1,374 @@
+// MIT License
+//
+// Syntacts
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent
+
+// Vectorized evaluation of simple Expression strings (internal, not installed).
+//
+// Parses the common subset of exprtk used by Expression signals (numbers, t, pi,
+// + - * / % ^, parentheses and elementary functions) into postfix code, which is
+// then evaluated a block at a time on a stack of vectors. The code holds no mutable
+// state, so it can be evaluated by any number of threads at once. Anything outside
+// of the subset fails to parse, and the caller falls back to exprtk.
+
+#pragma once
+
+#include <Tact/Config.hpp>
+#include <Tact/Util.hpp>
+#include <FastMath.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <string>
+#include <vector>
+
+namespace tact {
+namespace FastExpression {
+
+/// Postfix operations
+enum class Op : int {
+    Const, Time,                                            // push
+    Add, Sub, Mul, Div, Mod, Pow, Min, Max, Atan2,          // binary
+    Neg, Sin, Cos, Tan, Asin, Acos, Atan, Sinh, Cosh, Tanh, // unary
+    Exp, Log, Log10, Sqrt, Abs, Floor, Ceil
+};
+
+/// A postfix instruction
+struct Instruction {
+    Op     op;
+    double k; ///< value of Const
+};
+
+/// Postfix code of an expression of t
+struct Code {
+    std::vector<Instruction> ops;
+    int depth = 0; ///< maximum stack depth
+};
+
+/// Maximum stack depth of evaluation (deeper expressions fail to parse)
+constexpr int MAX_DEPTH = 16;
+
+/// Returns the number of operands of op
+inline int arity(Op op) {
+    if (op == Op::Const || op == Op::Time)
+        return 0;
+    if (op >= Op::Add && op <= Op::Atan2)
+        return 2;
+    return 1;
+}
+
+/// Applies a unary op to one value
+inline double apply(Op op, double a) {
+    switch (op) {
+        case Op::Neg:   return -a;
+        case Op::Sin:   return std::sin(a);
+        case Op::Cos:   return std::cos(a);
+        case Op::Tan:   return std::tan(a);
+        case Op::Asin:  return std::asin(a);
+        case Op::Acos:  return std::acos(a);
+        case Op::Atan:  return std::atan(a);
+        case Op::Sinh:  return std::sinh(a);
+        case Op::Cosh:  return std::cosh(a);
+        case Op::Tanh:  return std::tanh(a);
+        case Op::Exp:   return std::exp(a);
+        case Op::Log:   return std::log(a);
+        case Op::Log10: return std::log10(a);
+        case Op::Sqrt:  return std::sqrt(a);
+        case Op::Abs:   return std::abs(a);
+        case Op::Floor: return std::floor(a);
+        case Op::Ceil:  return std::ceil(a);
+        default:        return a;
+    }
+}
+
+/// Applies a binary op to two values
+inline double apply(Op op, double a, double b) {
+    switch (op) {
+        case Op::Add:   return a + b;
+        case Op::Sub:   return a - b;
+        case Op::Mul:   return a * b;
+        case Op::Div:   return a / b;
+        case Op::Mod:   return std::fmod(a, b);
+        case Op::Pow:   return std::pow(a, b);
+        case Op::Min:   return std::min(a, b);
+        case Op::Max:   return std::max(a, b);
+        case Op::Atan2: return std::atan2(a, b);
+        default:        return a;
+    }
+}
+
+/// Recursive descent parser producing constant folded postfix code
+class Parser {
+public:
+    explicit Parser(const std::string& str) : m_str(str) { }
+
+    /// Parses the whole string into code, returning false if it's outside of the supported subset
+    bool parse(Code& code) {
+        m_code.clear();
+        m_pos = 0;
+        if (!expression() || !end())
+            return false;
+        // compute stack depth
+        int depth = 0, max = 0;
+        for (auto& ins : m_code) {
+            depth += 1 - arity(ins.op);
+            max = std::max(max, depth);
+        }
+        if (max > MAX_DEPTH)
+            return false;
+        code.ops   = std::move(m_code);
+        code.depth = max;
+        return true;
+    }
+
+private:
+    // expression := term (('+' | '-') term)*
+    bool expression() {
+        if (!term())
+            return false;
+        while (true) {
+            if (accept('+')) {
+                if (!term()) return false;
+                emit(Op::Add);
+            }
+            else if (accept('-')) {
+                if (!term()) return false;
+                emit(Op::Sub);
+            }
+            else
+                return true;
+        }
+    }
+
+    // term := unary (('*' | '/' | '%') unary)*
+    bool term() {
+        if (!unary())
+            return false;
+        while (true) {
+            if (accept('*')) {
+                if (!unary()) return false;
+                emit(Op::Mul);
+            }
+            else if (accept('/')) {
+                if (!unary()) return false;
+                emit(Op::Div);
+            }
+            else if (accept('%')) {
+                if (!unary()) return false;
+                emit(Op::Mod);
+            }
+            else
+                return true;
+        }
+    }
+
+    // unary := ('-' | '+') unary | power
+    bool unary() {
+        if (accept('-')) {
+            if (!unary()) return false;
+            emit(Op::Neg);
+            return true;
+        }
+        if (accept('+'))
+            return unary();
+        return power();
+    }
+
+    // power := primary ('^' exponent)?   (a chain of '^' is rejected, since its associativity is ambiguous)
+    bool power() {
+        if (!primary())
+            return false;
+        if (accept('^')) {
+            if (!exponent()) return false;
+            if (peek() == '^') return false;
+            emit(Op::Pow);
+        }
+        return true;
+    }
+
+    // exponent := ('-' | '+') exponent | primary   (so t^-2 is t^(-2))
+    bool exponent() {
+        if (accept('-')) {
+            if (!exponent()) return false;
+            emit(Op::Neg);
+            return true;
+        }
+        if (accept('+'))
+            return exponent();
+        return primary();
+    }
+
+    // primary := number | 't' | 'pi' | function '(' expression (',' expression)? ')' | '(' expression ')'
+    bool primary() {
+        skip();
+        if (m_pos >= m_str.size())
+            return false;
+        char c = m_str[m_pos];
+        if (std::isdigit((unsigned char)c) || c == '.')
+            return number();
+        if (accept('('))
+            return expression() && accept(')');
+        if (!std::isalpha((unsigned char)c))
+            return false;
+        std::string name;
+        while (m_pos < m_str.size() && (std::isalnum((unsigned char)m_str[m_pos]) || m_str[m_pos] == '_'))
+            name += (char)std::tolower((unsigned char)m_str[m_pos++]);
+        if (name == "t") {
+            emit(Op::Time);
+            return true;
+        }
+        if (name == "pi") {
+            emitConst(PI);
+            return true;
+        }
+        static const std::pair<const char*, Op> unaries[] = {
+            {"sin", Op::Sin}, {"cos", Op::Cos}, {"tan", Op::Tan}, {"asin", Op::Asin}, {"acos", Op::Acos},
+            {"atan", Op::Atan}, {"sinh", Op::Sinh}, {"cosh", Op::Cosh}, {"tanh", Op::Tanh}, {"exp", Op::Exp},
+            {"log", Op::Log}, {"log10", Op::Log10}, {"sqrt", Op::Sqrt}, {"abs", Op::Abs}, {"floor", Op::Floor},
+            {"ceil", Op::Ceil}
+        };
+        static const std::pair<const char*, Op> binaries[] = {
+            {"min", Op::Min}, {"max", Op::Max}, {"atan2", Op::Atan2}
+        };
+        for (auto& f : unaries) {
+            if (name == f.first) {
+                if (!accept('(') || !expression() || !accept(')'))
+                    return false;
+                emit(f.second);
+                return true;
+            }
+        }
+        for (auto& f : binaries) {
+            if (name == f.first) {
+                if (!accept('(') || !expression() || !accept(',') || !expression() || !accept(')'))
+                    return false;
+                emit(f.second);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool number() {
+        const char* begin = m_str.c_str() + m_pos;
+        char* end = nullptr;
+        double value = std::strtod(begin, &end);
+        if (end == begin)
+            return false;
+        m_pos += end - begin;
+        // reject implicit multiplication (e.g. 2t) and hex/inf/nan forms handled by strtod
+        if (m_pos < m_str.size() && (std::isalpha((unsigned char)m_str[m_pos]) || m_str[m_pos] == '_'))
+            return false;
+        for (const char* p = begin; p != end; ++p) {
+            if (!std::isdigit((unsigned char)*p) && *p != '.' && *p != 'e' && *p != 'E' && *p != '+' && *p != '-')
+                return false;
+        }
+        emitConst(value);
+        return true;
+    }
+
+    void emitConst(double k) {
+        m_code.push_back({Op::Const, k});
+    }
+
+    /// Emits op, folding it if all of its operands are constant
+    void emit(Op op) {
+        int n = arity(op);
+        std::size_t size = m_code.size();
+        if (n == 1 && m_code[size-1].op == Op::Const) {
+            m_code[size-1].k = apply(op, m_code[size-1].k);
+            return;
+        }
+        if (n == 2 && m_code[size-1].op == Op::Const && m_code[size-2].op == Op::Const) {
+            m_code[size-2].k = apply(op, m_code[size-2].k, m_code[size-1].k);
+            m_code.pop_back();
+            return;
+        }
+        m_code.push_back({op, 0});
+    }
+
+    void skip() {
+        while (m_pos < m_str.size() && std::isspace((unsigned char)m_str[m_pos]))
+            ++m_pos;
+    }
+
+    char peek() {
+        skip();
+        return m_pos < m_str.size() ? m_str[m_pos] : '\0';
+    }
+
+    bool accept(char c) {
+        if (peek() != c)
+            return false;
+        ++m_pos;
+        return true;
+    }
+
+    bool end() {
+        return peek() == '\0' && m_pos == m_str.size();
+    }
+
+    const std::string& m_str;
+    std::size_t m_pos = 0;
+    std::vector<Instruction> m_code;
+};
+
+/// Evaluates code at n times t into b
+inline void evaluate(const Code& code, const double* t, double* b, int n) {
+    double stack[MAX_DEPTH][SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        const int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        const double* ti = t + i;
+        int sp = 0;
+        for (auto& ins : code.ops) {
+            const Op op = ins.op;
+            if (op == Op::Const) {
+                double* d = stack[sp++];
+                for (int j = 0; j < m; ++j) d[j] = ins.k;
+            }
+            else if (op == Op::Time) {
+                double* d = stack[sp++];
+                for (int j = 0; j < m; ++j) d[j] = ti[j];
+            }
+            else if (arity(op) == 2) {
+                double* a = stack[sp-2];
+                const double* c = stack[sp-1];
+                --sp;
+                switch (op) {
+                    case Op::Add: for (int j = 0; j < m; ++j) a[j] += c[j]; break;
+                    case Op::Sub: for (int j = 0; j < m; ++j) a[j] -= c[j]; break;
+                    case Op::Mul: for (int j = 0; j < m; ++j) a[j] *= c[j]; break;
+                    case Op::Div: for (int j = 0; j < m; ++j) a[j] /= c[j]; break;
+                    default:      for (int j = 0; j < m; ++j) a[j] = apply(op, a[j], c[j]); break;
+                }
+            }
+            else {
+                double* a = stack[sp-1];
+                switch (op) {
+                    case Op::Neg: for (int j = 0; j < m; ++j) a[j] = -a[j]; break;
+                    case Op::Sin: FastMath::sin(a, a, m); break;
+                    case Op::Cos: FastMath::cos(a, a, m); break;
+                    case Op::Exp: FastMath::exp(a, a, m); break;
+                    default:      for (int j = 0; j < m; ++j) a[j] = apply(op, a[j]); break;
+                }
+            }
+        }
+        for (int j = 0; j < m; ++j)
+            b[i + j] = stack[0][j];
+    }
+}
+
+} // namespace FastExpression
+} // namespace tact
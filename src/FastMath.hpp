@@ -0,0 +1,351 @@
+// MIT License
+//
+// Syntacts
+// Copyright (c) 2020 Mechatronics and Haptic Interfaces Lab - Rice University
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// Author(s): Evan Pezent
+
+// Block math kernels used by block sampling (internal, not installed).
+//
+// Kernels are straight-line, branch-free code so that loops over them are
+// auto-vectorized (see SYNTACTS_USE_NATIVE_ARCH for AVX2/AVX-512). Each kernel
+// first checks that the whole block is in range and otherwise falls back to
+// the scalar standard library. Accuracy is selected by SYNTACTS_FAST_MATH. With
+// SYNTACTS_USE_FLOAT, the sin, cos and exp kernels reduce their arguments in double but
+// evaluate their polynomials in float (~1e-7), twice as many lanes per instruction.
+// The rounding trick used for range reduction requires that the compiler does
+// not reassociate floating point math (i.e. no -ffast-math or /fp:fast).
+
+#pragma once
+
+#include <Tact/Config.hpp>
+#include <Tact/Util.hpp>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+namespace tact {
+namespace FastMath {
+
+///////////////////////////////////////////////////////////////////////////////
+// SCALAR BUILDING BLOCKS
+///////////////////////////////////////////////////////////////////////////////
+
+/// Rounds x to the nearest integer for |x| < 2^51 (vectorizable, unlike std::round)
+inline double round(double x) {
+    constexpr double MAGIC = 6755399441055744.0; // 1.5 * 2^52
+    return (x + MAGIC) - MAGIC;
+}
+
+/// Cody-Waite split of PI, so that x - k * PI is exact for moderate k
+constexpr double PI_A = 3.14159250259399414062;
+constexpr double PI_B = 1.509957883172319270672E-7;
+constexpr double PI_C = 1.0780605716316238105800E-14;
+/// Cody-Waite split of LN2
+constexpr double LN2_A = 6.93145751953125E-1;
+constexpr double LN2_B = 1.42860682030941723212E-6;
+/// Largest magnitude reduced by the trigonometric kernels
+constexpr double TRIG_LIMIT = 1e8;
+/// Largest magnitude accepted by the exponential kernel
+constexpr double EXP_LIMIT = 708;
+
+/// Reduces x = y + k * PI with y in [-PI/2, PI/2] and returns (-1)^k
+inline double reduce(double x, double& y) {
+    double k = round(x * INV_PI);
+    y = ((x - k * PI_A) - k * PI_B) - k * PI_C;
+    double h = k * 0.5;
+    return 1.0 - 4.0 * std::abs(h - round(h));
+}
+
+/// Wraps x to [-PI, PI]
+inline double wrap(double x) {
+    double k = round(x * (0.5 * INV_PI));
+    return ((x - k * (2 * PI_A)) - k * (2 * PI_B)) - k * (2 * PI_C);
+}
+
+/// sin(y) for y in [-PI/2, PI/2]
+inline double sinPoly(double y) {
+    double z = y * y;
+#if SYNTACTS_FAST_MATH >= 2
+    double p =    -1.0 / 121645100408832000.0;
+    p = p * z +  1.0 / 355687428096000.0;
+    p = p * z -  1.0 / 1307674368000.0;
+    p = p * z +  1.0 / 6227020800.0;
+    p = p * z -  1.0 / 39916800.0;
+#else
+    double p =    -1.0 / 39916800.0;
+#endif
+    p = p * z +  1.0 / 362880.0;
+    p = p * z -  1.0 / 5040.0;
+    p = p * z +  1.0 / 120.0;
+    p = p * z -  1.0 / 6.0;
+    return y + y * z * p;
+}
+
+/// cos(y) for y in [-PI/2, PI/2]
+inline double cosPoly(double y) {
+    double z = y * y;
+#if SYNTACTS_FAST_MATH >= 2
+    double p =     1.0 / 2432902008176640000.0;
+    p = p * z -  1.0 / 6402373705728000.0;
+    p = p * z +  1.0 / 20922789888000.0;
+    p = p * z -  1.0 / 87178291200.0;
+    p = p * z +  1.0 / 479001600.0;
+#else
+    double p =     1.0 / 479001600.0;
+#endif
+    p = p * z -  1.0 / 3628800.0;
+    p = p * z +  1.0 / 40320.0;
+    p = p * z -  1.0 / 720.0;
+    p = p * z +  1.0 / 24.0;
+    p = p * z -  1.0 / 2.0;
+    return 1.0 + z * p;
+}
+
+/// exp(x) for |x| <= EXP_LIMIT
+inline double expPoly(double x) {
+    double k = round(x * 1.4426950408889634); // log2(e)
+    double r = (x - k * LN2_A) - k * LN2_B;
+#if SYNTACTS_FAST_MATH >= 2
+    double p =     1.0 / 479001600.0;
+    p = p * r +  1.0 / 39916800.0;
+    p = p * r +  1.0 / 3628800.0;
+    p = p * r +  1.0 / 362880.0;
+    p = p * r +  1.0 / 40320.0;
+    p = p * r +  1.0 / 5040.0;
+#else
+    double p =     1.0 / 5040.0;
+#endif
+    p = p * r +  1.0 / 720.0;
+    p = p * r +  1.0 / 120.0;
+    p = p * r +  1.0 / 24.0;
+    p = p * r +  1.0 / 6.0;
+    p = p * r +  0.5;
+    p = p * r +  1.0;
+    p = p * r +  1.0;
+    // 2^k from the low mantissa bits of k + 2^52 + 1023
+    double e = k + 4503599627371519.0;
+    std::uint64_t bits;
+    std::memcpy(&bits, &e, sizeof(double));
+    bits <<= 52;
+    std::memcpy(&e, &bits, sizeof(double));
+    return p * e;
+}
+
+#ifdef SYNTACTS_USE_FLOAT
+
+/// sin(y) for y in [-PI/2, PI/2] in single precision
+inline float sinPolyF(float y) {
+    float z = y * y;
+    float p =    -1.0f / 39916800.0f;
+    p = p * z +  1.0f / 362880.0f;
+    p = p * z -  1.0f / 5040.0f;
+    p = p * z +  1.0f / 120.0f;
+    p = p * z -  1.0f / 6.0f;
+    return y + y * z * p;
+}
+
+/// cos(y) for y in [-PI/2, PI/2] in single precision
+inline float cosPolyF(float y) {
+    float z = y * y;
+    float p =     1.0f / 479001600.0f;
+    p = p * z -  1.0f / 3628800.0f;
+    p = p * z +  1.0f / 40320.0f;
+    p = p * z -  1.0f / 720.0f;
+    p = p * z +  1.0f / 24.0f;
+    p = p * z -  1.0f / 2.0f;
+    return 1.0f + z * p;
+}
+
+/// exp(r) for |r| <= LN2/2 in single precision
+inline float expPolyF(float r) {
+    float p =     1.0f / 5040.0f;
+    p = p * r +  1.0f / 720.0f;
+    p = p * r +  1.0f / 120.0f;
+    p = p * r +  1.0f / 24.0f;
+    p = p * r +  1.0f / 6.0f;
+    p = p * r +  0.5f;
+    p = p * r +  1.0f;
+    return p * r + 1.0f;
+}
+
+#endif
+
+/// Returns true if |x[i]| <= limit for all i (false for NaN)
+inline bool inRange(const double* x, int n, double limit) {
+    int out = 0;
+    for (int i = 0; i < n; ++i)
+        out |= !(std::abs(x[i]) <= limit);
+    return out == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// BLOCK KERNELS (x and y may alias)
+///////////////////////////////////////////////////////////////////////////////
+
+#ifdef SYNTACTS_USE_FLOAT
+
+/// y = sin(x), or cos(x) if Cos, for |x| <= TRIG_LIMIT. Each chunk is reduced in double, 
+/// evaluated in float and widened back in separate loops, so that each loop vectorizes 
+/// at its own lane width.
+template <bool Cos>
+inline void trigF(const double* x, double* y, int n) {
+    float r[SYNTACTS_BLOCK_SIZE];
+    float s[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        const int m = n - i < SYNTACTS_BLOCK_SIZE ? n - i : SYNTACTS_BLOCK_SIZE;
+        for (int j = 0; j < m; ++j) {
+            double q;
+            s[j] = static_cast<float>(reduce(x[i + j], q));
+            r[j] = static_cast<float>(q);
+        }
+        for (int j = 0; j < m; ++j)
+            r[j] = s[j] * (Cos ? cosPolyF(r[j]) : sinPolyF(r[j]));
+        for (int j = 0; j < m; ++j)
+            y[i + j] = r[j];
+    }
+}
+
+/// y = a * exp(k * x) for |k * x| <= EXP_LIMIT, with the polynomial in float (see trigF)
+inline void expF(const double* x, double* y, int n, double a, double k) {
+    float  r[SYNTACTS_BLOCK_SIZE];
+    double e[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        const int m = n - i < SYNTACTS_BLOCK_SIZE ? n - i : SYNTACTS_BLOCK_SIZE;
+        for (int j = 0; j < m; ++j) {
+            double v = k * x[i + j];
+            double c = round(v * 1.4426950408889634); // log2(e)
+            r[j] = static_cast<float>((v - c * LN2_A) - c * LN2_B);
+            // a * 2^c from the low mantissa bits of c + 2^52 + 1023
+            double b = c + 4503599627371519.0;
+            std::uint64_t bits;
+            std::memcpy(&bits, &b, sizeof(double));
+            bits <<= 52;
+            std::memcpy(&b, &bits, sizeof(double));
+            e[j] = a * b;
+        }
+        for (int j = 0; j < m; ++j)
+            r[j] = expPolyF(r[j]);
+        for (int j = 0; j < m; ++j)
+            y[i + j] = e[j] * r[j];
+    }
+}
+
+#endif
+
+/// y = sin(x)
+inline void sin(const double* x, double* y, int n) {
+#if SYNTACTS_FAST_MATH
+    if (inRange(x, n, TRIG_LIMIT)) {
+#ifdef SYNTACTS_USE_FLOAT
+        trigF<false>(x, y, n);
+#else
+        for (int i = 0; i < n; ++i) {
+            double r;
+            double s = reduce(x[i], r);
+            y[i] = s * sinPoly(r);
+        }
+#endif
+        return;
+    }
+#endif
+    for (int i = 0; i < n; ++i)
+        y[i] = std::sin(x[i]);
+}
+
+/// y = cos(x)
+inline void cos(const double* x, double* y, int n) {
+#if SYNTACTS_FAST_MATH
+    if (inRange(x, n, TRIG_LIMIT)) {
+#ifdef SYNTACTS_USE_FLOAT
+        trigF<true>(x, y, n);
+#else
+        for (int i = 0; i < n; ++i) {
+            double r;
+            double s = reduce(x[i], r);
+            y[i] = s * cosPoly(r);
+        }
+#endif
+        return;
+    }
+#endif
+    for (int i = 0; i < n; ++i)
+        y[i] = std::cos(x[i]);
+}
+
+/// y = a * exp(k * x)
+inline void exp(const double* x, double* y, int n, double a = 1, double k = 1) {
+#if SYNTACTS_FAST_MATH
+    int out = 0;
+    for (int i = 0; i < n; ++i)
+        out |= !(std::abs(k * x[i]) <= EXP_LIMIT);
+    if (out == 0) {
+#ifdef SYNTACTS_USE_FLOAT
+        expF(x, y, n, a, k);
+#else
+        for (int i = 0; i < n; ++i)
+            y[i] = a * expPoly(k * x[i]);
+#endif
+        return;
+    }
+#endif
+    for (int i = 0; i < n; ++i)
+        y[i] = a * std::exp(k * x[i]);
+}
+
+/// y = sin(x) > 0 ? 1 : -1
+inline void square(const double* x, double* y, int n) {
+#if SYNTACTS_FAST_MATH
+    if (inRange(x, n, TRIG_LIMIT)) {
+        for (int i = 0; i < n; ++i)
+            y[i] = wrap(x[i]) > 0 ? 1.0 : -1.0;
+        return;
+    }
+#endif
+    for (int i = 0; i < n; ++i)
+        y[i] = std::sin(x[i]) > 0 ? 1.0 : -1.0;
+}
+
+/// y = -2/PI * atan(cot(x/2)), evaluated as the equivalent linear ramp of the wrapped phase
+inline void saw(const double* x, double* y, int n) {
+#if SYNTACTS_FAST_MATH
+    if (inRange(x, n, TRIG_LIMIT)) {
+        for (int i = 0; i < n; ++i) {
+            double q = wrap(x[i]);
+            y[i] = q * INV_PI + (q < 0 ? 1.0 : -1.0);
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < n; ++i)
+        y[i] = -2 * INV_PI * std::atan(std::cos(0.5 * x[i]) / std::sin(0.5 * x[i]));
+}
+
+/// y = 2/PI * asin(sin(x)), evaluated as the equivalent piecewise linear function of the wrapped phase
+inline void triangle(const double* x, double* y, int n) {
+#if SYNTACTS_FAST_MATH
+    if (inRange(x, n, TRIG_LIMIT)) {
+        for (int i = 0; i < n; ++i) {
+            double q = wrap(x[i]);
+            q = q > HALF_PI ? PI - q : q < -HALF_PI ? -PI - q : q;
+            y[i] = 2 * INV_PI * q;
+        }
+        return;
+    }
+#endif
+    for (int i = 0; i < n; ++i)
+        y[i] = 2 * INV_PI * std::asin(std::sin(x[i]));
+}
+
+} // namespace FastMath
+} // namespace tact
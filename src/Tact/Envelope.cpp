@@ -1,5 +1,7 @@
 #include <Tact/Envelope.hpp>
 #include <Tact/Oscillator.hpp>
+#include <FastMath.hpp>
+#include <algorithm>
 #include <functional>
 
 namespace tact {
@@ -13,33 +15,117 @@ double Envelope::sample(double t) const {
     return t > duration ? 0.0f : amplitude;
 }
 
+void Envelope::sample(const double* t, double* b, int n) const {
+    for (int i = 0; i < n; ++i)
+        b[i] = t[i] > duration ? 0.0 : amplitude;
+}
+
 double Envelope::length() const {
     return duration;
 }
 
+Interval Envelope::support() const {
+    return {-INF, duration};
+}
+
 KeyedEnvelope::KeyedEnvelope(double amplitude0)
 {
    addKey(0.0f, amplitude0, Curves::Instant());
 }
 
 void KeyedEnvelope::addKey(double t, double amplitude, Curve curve) {
-    keys[t] = std::make_pair(amplitude, curve);
+    auto it = std::lower_bound(m_keys.begin(), m_keys.end(), t, [](const Key& key, double t) { return key.t < t; });
+    if (it != m_keys.end() && it->t == t)
+        *it = {t, amplitude, std::move(curve)};
+    else
+        m_keys.insert(it, {t, amplitude, std::move(curve)});
+    update();
+}
+
+void KeyedEnvelope::clearKeys() {
+    m_keys.clear();
+    m_segments.clear();
+}
+
+const std::vector<KeyedEnvelope::Key>& KeyedEnvelope::getKeys() const {
+    return m_keys;
+}
+
+void KeyedEnvelope::update() {
+    m_segments.resize(m_keys.size());
+    for (std::size_t i = 0; i < m_keys.size(); ++i) {
+        auto& b = m_keys[i];
+        auto& a = m_keys[i == 0 ? 0 : i - 1];
+        auto& s = m_segments[i];
+        s.t0     = a.t;
+        s.t1     = b.t;
+        s.a0     = a.amplitude;
+        s.a1     = b.amplitude;
+        s.scale  = i == 0 ? 0 : 1 / (b.t - a.t);
+        s.linear = b.curve.isType<Curves::Linear>();
+    }
+}
+
+std::size_t KeyedEnvelope::find(double t) const {
+    auto it = std::lower_bound(m_segments.begin(), m_segments.end(), t, [](const Segment& s, double t) { return s.t1 < t; });
+    return (std::size_t)(it - m_segments.begin());
+}
+
+inline double KeyedEnvelope::evaluate(std::size_t i, double t) const {
+    auto& s = m_segments[i];
+    if (t == s.t1)
+        return s.a1;
+    double u = (t - s.t0) * s.scale;
+    return s.linear ? s.a0 + (s.a1 - s.a0) * u : m_keys[i].curve(s.a0, s.a1, u);
 }
 
 double KeyedEnvelope::sample(double t) const {
-    if (t > length())
+    if (m_keys.empty() || t > m_keys.back().t)
         return 0.0f;
-    auto b = keys.lower_bound(t);
-    if (b->first == t)
-        return b->second.first;
-    auto a = std::prev(b);
-    t = (t - a->first) / (b->first - a->first);
-    double sample = b->second.second(a->second.first, b->second.first, t);    
-    return sample;
+    if (t <= m_keys.front().t)
+        return m_keys.front().amplitude;
+    return evaluate(find(t), t);
+}
+
+void KeyedEnvelope::sample(const double* t, double* b, int n) const {
+    if (m_keys.empty()) {
+        std::fill(b, b + n, 0.0);
+        return;
+    }
+    const double first = m_keys.front().t;
+    const double last  = m_keys.back().t;
+    // forward cursor over segments: sequential playback advances it at most a few
+    // segments per block, and any jump backward in time falls back to a binary search
+    std::size_t i = 0;
+    double prev   = INF;
+    for (int j = 0; j < n; ++j) {
+        const double tj = t[j];
+        if (tj > last)
+            b[j] = 0.0;
+        else if (tj <= first)
+            b[j] = m_keys.front().amplitude;
+        else {
+            if (tj < prev)
+                i = find(tj);
+            else {
+                while (m_segments[i].t1 < tj)
+                    ++i;
+            }
+            prev = tj;
+            b[j] = evaluate(i, tj);
+        }
+    }
 }
 
 double KeyedEnvelope::length() const {
-    return keys.rbegin()->first;
+    return m_keys.empty() ? 0.0 : m_keys.back().t;
+}
+
+Interval KeyedEnvelope::support() const {
+    if (m_keys.empty())
+        return {INF, -INF};
+    // the first key's amplitude is held before it
+    return {m_keys.front().amplitude == 0 ? m_keys.front().t : -INF, m_keys.back().t};
 }
 
 ASR::ASR(double attackTime, double sustainTime, double releaseTime, double attackAmplitude, Curve attackCurve, Curve releaseCurve)
@@ -64,6 +150,10 @@ double ExponentialDecay::sample(double t) const {
     return amplitude * std::exp(-decay * t);
 }
 
+void ExponentialDecay::sample(const double* t, double* b, int n) const {
+    FastMath::exp(t, b, n, amplitude, -decay);
+}
+
 double ExponentialDecay::length() const {
     return - std::log(0.001 /amplitude) / decay;
 }
@@ -80,8 +170,19 @@ double SignalEnvelope::sample(double t) const {
     return value;
 }
 
+void SignalEnvelope::sample(const double* t, double* b, int n) const {
+    signal.sample(t, b, n);
+    double len = length();
+    for (int i = 0; i < n; ++i)
+        b[i] = t[i] > len ? 0.0 : remap(b[i], -1, 1, 0, amplitude);
+}
+
 double SignalEnvelope::length() const {
     return duration;
 }
 
+Interval SignalEnvelope::support() const {
+    return {-INF, duration};
+}
+
 } // namespace tact
\ No newline at end of file
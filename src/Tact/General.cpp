@@ -3,6 +3,13 @@
 #include <misc/exprtk.hpp>
 #include <iostream>
 #include <Tact/Util.hpp>
+#include <FastExpression.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
 
 namespace tact
 {
@@ -13,24 +20,137 @@ double Scalar::sample(double t) const
     return value;
 }
 
+void Scalar::sample(const double* t, double* b, int n) const
+{
+    for (int i = 0; i < n; ++i)
+        b[i] = value;
+}
+
 double Scalar::length() const
 {
     return INF;
 }
 
+bool Scalar::isConstant() const
+{
+    return true;
+}
+
 Ramp::Ramp(double _initial, double _rate) : initial(_initial), rate(_rate), duration(INF) {}
 Ramp::Ramp(double _initial, double _final, double _duration) : initial(_initial), rate((_final - _initial) / _duration), duration(_duration) {}
 double Ramp::sample(double t) const { return initial + rate * t; }
+void Ramp::sample(const double* t, double* b, int n) const { for (int i = 0; i < n; ++i) b[i] = initial + rate * t[i]; }
 double Ramp::length() const { return duration; }
+bool Ramp::isConstant() const { return rate == 0; }
+
+namespace {
+
+/// splitmix64 finalizer
+inline std::uint64_t mix(std::uint64_t z) {
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+constexpr std::uint64_t GOLDEN = 0x9e3779b97f4a7c15ULL;
+
+/// Maps a hash to [-1,1)
+inline double uniform(std::uint64_t h) {
+    return static_cast<double>(h >> 11) * (2.0 / 9007199254740992.0) - 1.0;
+}
 
-Noise::Noise()
+/// Hashes the bit pattern of t with key
+inline std::uint64_t hash(double t, std::uint64_t key) {
+    std::uint64_t bits;
+    std::memcpy(&bits, &t, sizeof(double));
+    return mix(bits ^ key);
+}
+
+/// Rate of the fastest pink noise octave
+constexpr double PINK_RATE    = 48000;
+/// Number of sample and hold octaves summed for pink noise (~1.5 Hz to 24 kHz)
+constexpr int    PINK_OCTAVES = 15;
+
+/// Uniform white noise
+inline double uniformNoise(double t, std::uint64_t key) {
+    return uniform(hash(t, key));
+}
+
+/// Gaussian white noise (Box-Muller)
+inline double gaussianNoise(double t, std::uint64_t key) {
+    std::uint64_t h1 = hash(t, key);
+    std::uint64_t h2 = mix(h1 + GOLDEN);
+    double u1 = static_cast<double>((h1 >> 11) + 1) * (1.0 / 9007199254740992.0); // (0,1]
+    double u2 = static_cast<double>(h2 >> 11) * (1.0 / 9007199254740992.0);       // [0,1)
+    return std::sqrt(-2.0 * std::log(u1)) * std::cos(TWO_PI * u2) * (1.0 / 3.0);
+}
+
+/// Pink noise (Voss-McCartney): the average of white noise held for 1, 2, 4, ... periods of
+/// PINK_RATE, plus white noise for every sample. Held values are indexed by time, not state.
+inline double pinkNoise(double t, std::uint64_t key) {
+    std::int64_t j = static_cast<std::int64_t>(std::floor(t * PINK_RATE));
+    double sum = uniform(hash(t, key));
+    for (int k = 0; k < PINK_OCTAVES; ++k)
+        sum += uniform(mix(static_cast<std::uint64_t>(j >> k) + key + (k + 1) * GOLDEN));
+    return sum * (1.0 / (PINK_OCTAVES + 1));
+}
+
+/// Seeds for default constructed Noise
+std::atomic<std::uint64_t> g_nextSeed(1);
+
+} // private namespace
+
+Noise::Noise(Type _type) :
+    Noise(_type, g_nextSeed.fetch_add(1, std::memory_order_relaxed))
+{ }
+
+Noise::Noise(Type _type, std::uint64_t _seed) :
+    type(_type), seed(_seed)
 { }
 
 double Noise::sample(double t) const
 {
-    static std::uniform_real_distribution<double> dist(-1,1);
-    static std::mt19937 rgen;
-    return dist(rgen);
+    const std::uint64_t key = mix(seed + GOLDEN);
+    if (type == Type::Gaussian)
+        return gaussianNoise(t, key);
+    if (type == Type::Pink)
+        return pinkNoise(t, key);
+    return uniformNoise(t, key);
+}
+
+void Noise::sample(const double* t, double* b, int n) const
+{
+    const std::uint64_t key = mix(seed + GOLDEN);
+    if (type == Type::Gaussian) {
+        for (int i = 0; i < n; ++i)
+            b[i] = gaussianNoise(t[i], key);
+    }
+    else if (type == Type::Pink) {
+        // held octave values rarely change within a block, so only rehash those that do
+        std::int64_t held[PINK_OCTAVES];
+        double values[PINK_OCTAVES];
+        for (int k = 0; k < PINK_OCTAVES; ++k) {
+            held[k] = INT64_MIN;
+            values[k] = 0;
+        }
+        for (int i = 0; i < n; ++i) {
+            std::int64_t j = static_cast<std::int64_t>(std::floor(t[i] * PINK_RATE));
+            for (int k = 0; k < PINK_OCTAVES; ++k) {
+                if ((j >> k) != held[k]) {
+                    held[k] = j >> k;
+                    values[k] = uniform(mix(static_cast<std::uint64_t>(held[k]) + key + (k + 1) * GOLDEN));
+                }
+            }
+            double sum = uniform(hash(t[i], key));
+            for (int k = 0; k < PINK_OCTAVES; ++k)
+                sum += values[k];
+            b[i] = sum * (1.0 / (PINK_OCTAVES + 1));
+        }
+    }
+    else {
+        for (int i = 0; i < n; ++i)
+            b[i] = uniformNoise(t[i], key);
+    }
 }
 
 double Noise::length() const
@@ -38,49 +158,151 @@ double Noise::length() const
     return INF;
 }
 
+/// Immutable compiled expression, shared between copies and cached by string
 class Expression::Impl
 {
 public:
-    Impl() : m_t(0) {}
+    explicit Impl(const std::string& expr) : m_str(expr) {
+        // simple expressions are evaluated by vectorized code, and only the rest by exprtk
+        m_fast = FastExpression::Parser(m_str).parse(m_code);
+        if (m_fast) {
+            m_valid = true;
+            return;
+        }
+        // compile the whole pool here, so that sampling never parses or waits for another thread
+        m_evals[0] = compile();
+        m_valid = m_evals[0] != nullptr;
+        for (std::size_t i = 0; i < MAX_EVALUATORS; ++i) {
+            if (i > 0)
+                m_evals[i] = m_valid ? compile() : nullptr;
+            if (!m_evals[i])
+                m_evals[i] = uncompiled();
+            m_state[i].store(Free, std::memory_order_relaxed);
+        }
+    }
 
     double sample(double t) const
     {
-        m_t = t;
-        return m_expr.value();
+        double b;
+        sample(&t, &b, 1);
+        return b;
     }
-    bool setExpression(const std::string &expr)
+
+    void sample(const double* t, double* b, int n) const
     {
-        m_str = expr;
-        m_table.add_variable("t", m_t);
-        m_table.add_pi();
-        m_expr.register_symbol_table(m_table);
-        return m_parser.compile(m_str, m_expr);
-    }
-    exprtk::symbol_table<double> m_table;
-    exprtk::expression<double> m_expr;
-    exprtk::parser<double> m_parser;
-    std::string m_str;
-    mutable double m_t;
+        if (m_fast) {
+            FastExpression::evaluate(m_code, t, b, n);
+            return;
+        }
+        std::size_t i = acquire();
+        if (i == MAX_EVALUATORS) {
+            // more threads are sampling this expression than there are evaluators, so rather 
+            // than wait for one, evaluate with a private copy
+            auto eval = m_valid ? compile() : uncompiled();
+            evaluate(*eval, t, b, n);
+            return;
+        }
+        evaluate(*m_evals[i], t, b, n);
+        release(i);
+    }
+
+    /// Returns the shared compiled form of expr, compiling it if it isn't cached
+    static std::shared_ptr<const Impl> get(const std::string& expr) {
+        static std::mutex mutex;
+        static std::unordered_map<std::string, std::weak_ptr<const Impl>> cache;
+        std::lock_guard<std::mutex> lock(mutex);
+        auto& entry = cache[expr];
+        auto impl = entry.lock();
+        if (!impl) {
+            impl = std::make_shared<const Impl>(expr);
+            entry = impl;
+            // sweep expired entries once the cache has doubled in size
+            static std::size_t sweep = 64;
+            if (cache.size() >= sweep) {
+                for (auto it = cache.begin(); it != cache.end(); )
+                    it = it->second.expired() ? cache.erase(it) : std::next(it);
+                sweep = std::max<std::size_t>(64, 2 * cache.size());
+            }
+        }
+        return impl;
+    }
+
+    const std::string m_str;
+    bool m_valid;
+    bool m_fast;                  ///< true if evaluated by m_code instead of exprtk
+    FastExpression::Code m_code;  ///< vectorized code if m_fast
+
+private:
+    /// exprtk binds variables by reference, so each thread sampling concurrently needs its own instance
+    struct Evaluator {
+        double t = 0;
+        exprtk::symbol_table<double> table;
+        exprtk::expression<double> expr;
+    };
+
+    /// Evaluator slot states
+    enum State : int { Free, Busy };
+    /// Number of threads that can sample the same expression at once without contention
+    static constexpr std::size_t MAX_EVALUATORS = 8;
+
+    std::unique_ptr<Evaluator> compile() const {
+        auto eval = std::make_unique<Evaluator>();
+        eval->table.add_variable("t", eval->t);
+        eval->table.add_pi();
+        eval->expr.register_symbol_table(eval->table);
+        exprtk::parser<double> parser;
+        if (!parser.compile(m_str, eval->expr))
+            return nullptr;
+        return eval;
+    }
+
+    /// Returns an evaluator for an invalid expression, so that sampling behaves as it always has
+    static std::unique_ptr<Evaluator> uncompiled() {
+        auto eval = std::make_unique<Evaluator>();
+        eval->expr.register_symbol_table(eval->table);
+        return eval;
+    }
+
+    static void evaluate(Evaluator& eval, const double* t, double* b, int n) {
+        for (int j = 0; j < n; ++j) {
+            eval.t = t[j];
+            b[j] = eval.expr.value();
+        }
+    }
+
+    /// Claims a free evaluator, or returns MAX_EVALUATORS if all are busy
+    std::size_t acquire() const {
+        for (std::size_t i = 0; i < MAX_EVALUATORS; ++i) {
+            int free = Free;
+            if (m_state[i].compare_exchange_strong(free, Busy, std::memory_order_acquire))
+                return i;
+        }
+        return MAX_EVALUATORS;
+    }
+
+    void release(std::size_t i) const {
+        m_state[i].store(Free, std::memory_order_release);
+    }
+
+    std::unique_ptr<Evaluator> m_evals[MAX_EVALUATORS]; ///< compiled at construction
+    mutable std::atomic<int> m_state[MAX_EVALUATORS] = {};
 };
 
-Expression::Expression(const std::string &expr) : m_impl(std::move(std::make_unique<Expression::Impl>()))
+Expression::Expression(const std::string &expr)
 {
     setExpression(expr);
 }
 
-Expression::~Expression() {
-    
-}
-
-Expression::Expression(const Expression& other) :
-    Expression(other.getExpression())
-{ }
-
 double Expression::sample(double t) const
 {
     return m_impl->sample(t);
 }
 
+void Expression::sample(const double* t, double* b, int n) const
+{
+    m_impl->sample(t, b, n);
+}
+
 double Expression::length() const
 {
     return INF;
@@ -88,7 +310,8 @@ double Expression::length() const
 
 bool Expression::setExpression(const std::string &expr)
 {
-    return m_impl->setExpression(expr);
+    m_impl = Impl::get(expr);
+    return m_impl->m_valid;
 }
 
 const std::string& Expression::getExpression() const {
@@ -100,18 +323,102 @@ bool Expression::operator=(const std::string &expr)
     return setExpression(expr);
 }
 
+namespace {
+
+/// Evaluates the cubic Bezier between point groups l and r at parameter u
+inline PolyBezier::Point bezier(const PolyBezier::PointGroup& l, const PolyBezier::PointGroup& r, double u) {
+    double v  = 1.0 - u;
+    double w1 = v*v*v;
+    double w2 = 3*v*v*u;
+    double w3 = 3*v*u*u;
+    double w4 = u*u*u;
+    return { w1*l.p.t + w2*l.cpR.t + w3*r.cpL.t + w4*r.p.t,
+             w1*l.p.y + w2*l.cpR.y + w3*r.cpL.y + w4*r.p.y };
+}
+
+/// Returns the distance from p to the segment between p0 and p1
+inline double distance(const PolyBezier::Point& p, const PolyBezier::Point& p0, const PolyBezier::Point& p1) {
+    double dt = p1.t - p0.t, dy = p1.y - p0.y;
+    double len2 = dt * dt + dy * dy;
+    double s = len2 > 0 ? clamp01(((p.t - p0.t) * dt + (p.y - p0.y) * dy) / len2) : 0;
+    return std::hypot(p.t - (p0.t + s * dt), p.y - (p0.y + s * dy));
+}
+
+/// Maximum recursion depth of tessellation (at most 2^16 lines per curve)
+constexpr int BEZIER_MAX_DEPTH = 16;
+
+/// Appends lines approximating the curve over (u0,u1] to within SYNTACTS_BEZIER_TOLERANCE
+void tessellate(const PolyBezier::PointGroup& l, const PolyBezier::PointGroup& r, 
+                double u0, const PolyBezier::Point& p0, double u1, const PolyBezier::Point& p1, 
+                int depth, std::vector<PolyBezier::Point>& out) 
+{
+    if (depth < BEZIER_MAX_DEPTH) {
+        // compare the curve to the chord at the quarter points, which also catches 
+        // inflections whose midpoint happens to lie on the chord. Where control points pull
+        // the curve outside of the chord's time span, the chord can't be extrapolated to it,
+        // so measure the distance to the chord instead, which shrinks as the curve is split
+        double um = 0.5 * (u0 + u1);
+        auto pm = bezier(l, r, um);
+        bool flat = true;
+        for (double u : {0.5 * (u0 + um), um, 0.5 * (um + u1)}) {
+            auto p = u == um ? pm : bezier(l, r, u);
+            double error = p1.t > p0.t && p.t >= p0.t && p.t <= p1.t
+                         ? std::abs(p.y - remap(p.t, p0.t, p1.t, p0.y, p1.y))
+                         : distance(p, p0, p1);
+            if (error > SYNTACTS_BEZIER_TOLERANCE) {
+                flat = false;
+                break;
+            }
+        }
+        if (!flat) {
+            tessellate(l, r, u0, p0, um, pm, depth + 1, out);
+            tessellate(l, r, um, pm, u1, p1, depth + 1, out);
+            return;
+        }
+    }
+    out.push_back(p1);
+}
+
+} // private namespace
+
 double PolyBezier::sample(double t) const {
-    if (solution.size() < 2)
-        return 0; 
-    else {
-        auto it = std::find_if(solution.begin(), solution.end(), [&](const Point& p){return p.t > t; } );
-        if (it == solution.begin() || it == solution.end())
-            return 0; 
+    // first solution point after t
+    auto it = std::upper_bound(solution.begin(), solution.end(), t, [](double t, const Point& p) { return t < p.t; });
+    if (it == solution.begin() || it == solution.end())
+        return 0;
+    const Point& p0 = *std::prev(it);
+    const Point& p1 = *it;
+    return remap(t, p0.t, p1.t, p0.y, p1.y);
+}
+
+void PolyBezier::sample(const double* t, double* b, int n) const {
+    if (solution.size() < 2) {
+        std::fill(b, b + n, 0.0);
+        return;
+    }
+    const std::size_t count = solution.size();
+    const double first = solution.front().t;
+    const double last  = solution.back().t;
+    // forward cursor to the first solution point after t, which only advances for sequential
+    // playback and falls back to a binary search when time jumps backward
+    std::size_t i = 0;
+    double prev   = INF;
+    for (int j = 0; j < n; ++j) {
+        const double tj = t[j];
+        if (!(tj >= first && tj < last)) {
+            b[j] = 0;
+            continue;
+        }
+        if (tj < prev)
+            i = std::upper_bound(solution.begin(), solution.end(), tj, [](double t, const Point& p) { return t < p.t; }) - solution.begin();
         else {
-            const Point& p0 = *(std::prev(it));
-            const Point& p1 = *it;   
-            return remap(t, p0.t, p1.t, p0.y, p1.y);         
+            while (i < count && solution[i].t <= tj)
+                ++i;
         }
+        prev = tj;
+        const Point& p0 = solution[i-1];
+        const Point& p1 = solution[i];
+        b[j] = remap(tj, p0.t, p1.t, p0.y, p1.y);
     }
 }
 
@@ -121,26 +428,25 @@ double PolyBezier::length() const {
     return 0;
 }
 
+Interval PolyBezier::support() const {
+    if (solution.size() < 2)
+        return {INF, -INF};
+    return {solution.front().t, solution.back().t};
+}
+
 void PolyBezier::solve() {
-    constexpr int segments = 16;
     solution.clear();
     if (points.size() > 1) {
-        std::size_t beziers = points.size() - 1;
-        solution.reserve(segments * beziers);
-        for (int b = 0; b < beziers; ++b) {
-            for (int i = 0; i < segments; ++i) {
-                auto& l = points[b];
-                auto& r = points[b+1];
-                double t = (double)i / (double)(segments-1);
-                double u = 1.0f - t;
-                double w1 = u*u*u;
-                double w2 = 3*u*u*t;
-                double w3 = 3*u*t*t;
-                double w4 = t*t*t;
-                double x = w1*l.p.t + w2*l.cpR.t + w3*r.cpL.t + w4*r.p.t;
-                double y = w1*l.p.y + w2*l.cpR.y + w3*r.cpL.y + w4*r.p.y;
-                solution.push_back({x,y});
-            }
+        solution.push_back(points.front().p);
+        for (std::size_t b = 0; b + 1 < points.size(); ++b) {
+            auto& l = points[b];
+            auto& r = points[b+1];
+            std::size_t first = solution.size();
+            tessellate(l, r, 0, bezier(l, r, 0), 1, bezier(l, r, 1), 0, solution);
+            // control points may pull a curve backward in time; keep the solution sorted
+            // so that it can be binary searched
+            for (std::size_t i = first; i < solution.size(); ++i)
+                solution[i].t = std::max(solution[i].t, solution[i-1].t);
         }
     }
 }
@@ -155,17 +461,155 @@ Samples::Samples(const std::vector<float>& samples, double sampleRate) :
     m_sampleRate(sampleRate)
 { }
 
+namespace {
+
+/// Half width of the windowed sinc kernel in samples
+constexpr int SINC_HALF   = 8;
+/// Number of taps of the windowed sinc kernel
+constexpr int SINC_TAPS   = 2 * SINC_HALF;
+/// Number of fractional positions between samples at which the sinc kernel is tabulated
+constexpr int SINC_PHASES = 512;
+
+/// Blackman windowed sinc kernel, normalized to unity gain. Row p weights samples i - SINC_HALF + 1 
+/// through i + SINC_HALF for a position p / SINC_PHASES past sample i.
+struct SincTable {
+    SincTable() {
+        for (int p = 0; p <= SINC_PHASES; ++p) {
+            double f = (double)p / SINC_PHASES;
+            double h[SINC_TAPS];
+            double sum = 0;
+            for (int k = 0; k < SINC_TAPS; ++k) {
+                double d = k - (SINC_HALF - 1) - f;
+                double s = d == 0 ? 1 : std::sin(PI * d) / (PI * d);
+                double w = 0.42 + 0.5 * std::cos(PI * d / SINC_HALF) + 0.08 * std::cos(TWO_PI * d / SINC_HALF);
+                h[k] = s * w;
+                sum += h[k];
+            }
+            for (int k = 0; k < SINC_TAPS; ++k)
+                weights[p][k] = static_cast<float>(h[k] / sum);
+        }
+    }
+    float weights[SINC_PHASES + 1][SINC_TAPS];
+};
+
+const SincTable& sincTable() {
+    static const SincTable table;
+    return table;
+}
+
+/// Interpolates a recording of count samples at fractional index x in [0, count - 1]. Taps outside of
+/// the recording read as zero if Checked, and must not occur otherwise.
+template <Interpolation Mode, bool Checked>
+inline double interpolate(const float* data, std::int64_t count, double x, const SincTable& table) {
+    auto at = [=](std::int64_t j) -> double { return !Checked || (j >= 0 && j < count) ? data[j] : 0.0; };
+    std::int64_t i = static_cast<std::int64_t>(x);
+    double f = x - i;
+    if (Mode == Interpolation::Nearest)
+        return data[i];
+    if (Mode == Interpolation::Linear) {
+        double y0 = at(i), y1 = at(i+1);
+        return y0 + f * (y1 - y0);
+    }
+    if (Mode == Interpolation::Cubic) {
+        // Catmull-Rom spline
+        double y0 = at(i-1), y1 = at(i), y2 = at(i+1), y3 = at(i+2);
+        double c1 = 0.5 * (y2 - y0);
+        double c2 = y0 - 2.5 * y1 + 2 * y2 - 0.5 * y3;
+        double c3 = 0.5 * (y3 - y0) + 1.5 * (y1 - y2);
+        return ((c3 * f + c2) * f + c1) * f + y1;
+    }
+    // windowed sinc, linearly interpolating the kernel between tabulated phases (accumulated
+    // in single precision like the recording itself, which halves the cost of the taps)
+    double p = f * SINC_PHASES;
+    int    q = static_cast<int>(p);
+    q = q < SINC_PHASES ? q : SINC_PHASES - 1;
+    double g = p - q;
+    const float* w0 = table.weights[q];
+    const float* w1 = table.weights[q+1];
+    const float  h  = static_cast<float>(g);
+    std::int64_t j = i - (SINC_HALF - 1);
+    float y = 0;
+    if (Checked) {
+        for (int k = 0; k < SINC_TAPS; ++k)
+            y += (w0[k] + h * (w1[k] - w0[k])) * static_cast<float>(at(j + k));
+    }
+    else {
+        const float* d = data + j;
+        for (int k = 0; k < SINC_TAPS; ++k)
+            y += (w0[k] + h * (w1[k] - w0[k])) * d[k];
+    }
+    return y;
+}
+
+/// Interpolates a recording at fractional index x, or returns zero if x is outside of it
+template <Interpolation Mode>
+inline double interpolateChecked(const float* data, std::int64_t count, double x) {
+    if (Mode == Interpolation::Nearest) {
+        // hold each sample (the original behavior)
+        std::size_t i = static_cast<std::size_t>(x);
+        return i < static_cast<std::size_t>(count - 1) ? data[i] : 0.0;
+    }
+    if (!(x >= 0 && x <= count - 1))
+        return 0;
+    return interpolate<Mode, true>(data, count, x, sincTable());
+}
+
+/// Samples a recording at n times t. When time is monotonic across the block, its ends bound 
+/// every tap, so blocks away from the edges are read without any bounds checks.
+template <Interpolation Mode>
+inline void resample(const float* data, std::int64_t count, double rate, const double* t, double* b, int n) {
+    if (n <= 0)
+        return;
+    int backward = 0;
+    for (int i = 1; i < n; ++i)
+        backward |= !(t[i] >= t[i-1]);
+    double x0 = t[0] * rate;
+    double x1 = t[n-1] * rate;
+    if (backward == 0 && x0 >= SINC_HALF && x1 < count - SINC_HALF - 1) {
+        const SincTable& table = sincTable();
+        for (int i = 0; i < n; ++i)
+            b[i] = interpolate<Mode, false>(data, count, t[i] * rate, table);
+        return;
+    }
+    for (int i = 0; i < n; ++i)
+        b[i] = interpolateChecked<Mode>(data, count, t[i] * rate);
+}
+
+} // private namespace
+
 double Samples::sample(double t) const {
-    std::size_t i = static_cast<std::size_t>(t * m_sampleRate);
-    if (i < m_samples->size() - 1) 
-        return m_samples->operator[](i);
+    const float* data = m_samples->data();
+    const std::int64_t count = static_cast<std::int64_t>(m_samples->size());
+    const double x = t * m_sampleRate;
+    switch (interpolation) {
+        case Interpolation::Nearest: return interpolateChecked<Interpolation::Nearest>(data, count, x);
+        case Interpolation::Linear:  return interpolateChecked<Interpolation::Linear>(data, count, x);
+        case Interpolation::Cubic:   return interpolateChecked<Interpolation::Cubic>(data, count, x);
+        case Interpolation::Sinc:    return interpolateChecked<Interpolation::Sinc>(data, count, x);
+    }
     return 0;
 }
 
+void Samples::sample(const double* t, double* b, int n) const {
+    const float* data = m_samples->data();
+    const std::int64_t count = static_cast<std::int64_t>(m_samples->size());
+    switch (interpolation) {
+        case Interpolation::Nearest: resample<Interpolation::Nearest>(data, count, m_sampleRate, t, b, n); break;
+        case Interpolation::Linear:  resample<Interpolation::Linear>(data, count, m_sampleRate, t, b, n); break;
+        case Interpolation::Cubic:   resample<Interpolation::Cubic>(data, count, m_sampleRate, t, b, n); break;
+        case Interpolation::Sinc:    resample<Interpolation::Sinc>(data, count, m_sampleRate, t, b, n); break;
+    }
+}
+
 double Samples::length() const {
     return static_cast<double>(m_samples->size()) / m_sampleRate;
 }
 
+Interval Samples::support() const {
+    // Nearest holds the first sample from just before zero
+    return {-1 / m_sampleRate, static_cast<double>(m_samples->size()) / m_sampleRate};
+}
+
 int Samples::sampleCount() const {
     return static_cast<int>(m_samples->size());
 }
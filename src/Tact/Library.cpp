@@ -9,6 +9,8 @@
 #include <Tact/Envelope.hpp>
 #include <Tact/Operator.hpp>
 #include <Tact/Process.hpp>
+#include <Tact/Program.hpp>
+#include <Tact/Plugin.hpp>
 #include <Filesystem.hpp>
 
 #include <fstream>
@@ -34,19 +36,22 @@ namespace fs = std::filesystem;
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Scalar>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Time>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Ramp>);
-CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Noise>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Expression>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::PolyBezier>);
-CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Samples>);
 
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Sum>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Product>);
-CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Sequence>);
+CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Mix>);
+CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Modulation>);
 
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Sine>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Square>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Saw>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Triangle>);
+CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::WavetableSine>);
+CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::WavetableSquare>);
+CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::WavetableSaw>);
+CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::WavetableTriangle>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Pwm>);
 
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Envelope>);
@@ -59,6 +64,20 @@ CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::SignalEnvelope>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Repeater>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Stretcher>);
 CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Reverser>);
+CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::TimeMap>);
+
+CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Program>);
+CEREAL_REGISTER_TYPE(tact::Signal::Model<tact::Plugin>);
+
+// Models whose layout changed are registered under new names, and their old names read the old
+// layout through LegacyModels, so that Signals saved before the change still load
+
+CEREAL_REGISTER_TYPE_WITH_NAME(tact::Signal::Model<tact::Noise>, "tact::Signal::Model<tact::Noise>#1");
+CEREAL_REGISTER_TYPE_WITH_NAME(tact::Signal::LegacyModel<tact::Noise>, "tact::Signal::Model<tact::Noise>");
+CEREAL_REGISTER_TYPE_WITH_NAME(tact::Signal::Model<tact::Samples>, "tact::Signal::Model<tact::Samples>#1");
+CEREAL_REGISTER_TYPE_WITH_NAME(tact::Signal::LegacyModel<tact::Samples>, "tact::Signal::Model<tact::Samples>");
+CEREAL_REGISTER_TYPE_WITH_NAME(tact::Signal::Model<tact::Sequence>, "tact::Signal::Model<tact::Sequence>#1");
+CEREAL_REGISTER_TYPE_WITH_NAME(tact::Signal::LegacyModel<tact::Sequence>, "tact::Signal::Model<tact::Sequence>");
 
 CEREAL_REGISTER_TYPE(tact::Curve::Model<tact::Curves::Instant>);
 CEREAL_REGISTER_TYPE(tact::Curve::Model<tact::Curves::Delayed>);
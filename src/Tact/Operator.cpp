@@ -1,27 +1,291 @@
 #include <Tact/Operator.hpp>
 #include <algorithm>
+#include <iterator>
 
 namespace tact
 {
 
+namespace {
+
+/// Returns the smallest interval containing a and b
+inline Interval hull(const Interval& a, const Interval& b) {
+    return {std::min(a.start, b.start), std::max(a.end, b.end)};
+}
+
+/// Returns the intersection of a and b
+inline Interval intersect(const Interval& a, const Interval& b) {
+    return {std::max(a.start, b.start), std::min(a.end, b.end)};
+}
+
+/// Returns the support of a factor, which is everywhere if it has a bias
+inline Interval factorSupport(const Signal& sig) {
+    return sig.bias == 0 ? sig.support() : Interval{-INF, INF};
+}
+
+/// Finds the earliest and latest of n times t
+inline void bounds(const double* t, int n, double& lo, double& hi) {
+    lo = hi = t[0];
+    for (int i = 1; i < n; ++i) {
+        lo = std::min(lo, t[i]);
+        hi = std::max(hi, t[i]);
+    }
+}
+
+/// Returns true if [lo,hi] lies outside of s
+inline bool outside(const Interval& s, double lo, double hi) {
+    return hi < s.start || lo > s.end;
+}
+
+/// Samples a term of a sum, which is only its bias outside of its support
+inline double sampleTerm(const Signal& sig, double t) {
+    return outside(sig.support(), t, t) ? sig.bias : sig.sample(t);
+}
+
+/// Samples a term of a sum at m times t in [lo,hi] into b, or adds it to b if accumulate.
+/// Terms whose support doesn't cover the block aren't sampled.
+void sampleTerm(const Signal& sig, const double* t, double* b, double* tmp, int m, double lo, double hi, bool accumulate) {
+    if (outside(sig.support(), lo, hi)) {
+        if (!accumulate)
+            std::fill(b, b + m, sig.bias);
+        else if (sig.bias != 0) {
+            for (int j = 0; j < m; ++j)
+                b[j] += sig.bias;
+        }
+    }
+    else if (!accumulate)
+        sig.sample(t, b, m);
+    else {
+        sig.sample(t, tmp, m);
+        for (int j = 0; j < m; ++j)
+            b[j] += tmp[j];
+    }
+}
+
+/// Appends signals to out, expanding nested Sums and Mixes into their terms without recursion.
+/// Their gains are distributed over their terms and their biases accumulated in offset.
+void expandSum(std::vector<Signal>& signals, std::vector<Signal>& out, double& offset) {
+    std::vector<Signal> stack(std::make_move_iterator(signals.rbegin()), std::make_move_iterator(signals.rend()));
+    while (!stack.empty()) {
+        Signal sig = std::move(stack.back());
+        stack.pop_back();
+        if (sig.isType<Sum>()) {
+            offset += sig.bias;
+            auto op = sig.getAs<Sum>();
+            stack.push_back(std::move(op->rhs) * sig.gain);
+            stack.push_back(std::move(op->lhs) * sig.gain);
+        }
+        else if (sig.isType<Mix>()) {
+            offset += sig.bias;
+            auto& terms = sig.getAs<Mix>()->signals;
+            for (auto it = terms.rbegin(); it != terms.rend(); ++it)
+                stack.push_back(std::move(*it) * sig.gain);
+        }
+        else
+            out.push_back(std::move(sig));
+    }
+}
+
+/// Appends signals to out, expanding nested Products and Modulations without bias into 
+/// their factors without recursion. Their gains are moved onto their first factors.
+void expandProduct(std::vector<Signal>& signals, std::vector<Signal>& out) {
+    std::vector<Signal> stack(std::make_move_iterator(signals.rbegin()), std::make_move_iterator(signals.rend()));
+    while (!stack.empty()) {
+        Signal sig = std::move(stack.back());
+        stack.pop_back();
+        if (sig.isType<Product>() && sig.bias == 0) {
+            auto op = sig.getAs<Product>();
+            stack.push_back(std::move(op->rhs));
+            stack.push_back(std::move(op->lhs) * sig.gain);
+        }
+        else if (sig.isType<Modulation>() && sig.bias == 0 && !sig.getAs<Modulation>()->signals.empty()) {
+            auto& factors = sig.getAs<Modulation>()->signals;
+            factors[0] *= sig.gain;
+            for (auto it = factors.rbegin(); it != factors.rend(); ++it)
+                stack.push_back(std::move(*it));
+        }
+        else
+            out.push_back(std::move(sig));
+    }
+}
+
+} // namespace
+
 IOperator::IOperator(Signal _lhs, Signal _rhs) :
     lhs(std::move(_lhs)), rhs(std::move(_rhs))
 { }
 
+INaryOperator::INaryOperator(std::vector<Signal> _signals) :
+    signals(std::move(_signals))
+{ }
+
 double Sum::sample(double t) const {
-    return lhs.sample(t) + rhs.sample(t);
+    return sampleTerm(lhs, t) + sampleTerm(rhs, t);
+}
+
+void Sum::sample(const double* t, double* b, int n) const {
+    double tmp[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        double lo, hi;
+        bounds(t + i, m, lo, hi);
+        sampleTerm(lhs, t + i, b + i, tmp, m, lo, hi, false);
+        sampleTerm(rhs, t + i, b + i, tmp, m, lo, hi, true);
+    }
 }
 
 double Sum::length() const {
     return std::max(lhs.length(), rhs.length());
 }
 
+bool Sum::isConstant() const {
+    return lhs.isConstant() && rhs.isConstant();
+}
+
+Interval Sum::support() const {
+    return lhs.bias + rhs.bias == 0 ? hull(lhs.support(), rhs.support()) : Interval{-INF, INF};
+}
+
 double Product::sample(double t) const {
+    if (outside(support(), t, t))
+        return 0;
     return lhs.sample(t) * rhs.sample(t);
 }
 
+void Product::sample(const double* t, double* b, int n) const {
+    const Interval s = support();
+    double tmp[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        double lo, hi;
+        bounds(t + i, m, lo, hi);
+        if (outside(s, lo, hi)) {
+            std::fill(b + i, b + i + m, 0.0);
+            continue;
+        }
+        lhs.sample(t + i, b + i, m);
+        rhs.sample(t + i, tmp, m);
+        for (int j = 0; j < m; ++j)
+            b[i + j] *= tmp[j];
+    }
+}
+
 double Product::length() const {
     return std::min(lhs.length(), rhs.length());
 }
 
+bool Product::isConstant() const {
+    return lhs.isConstant() && rhs.isConstant();
+}
+
+Interval Product::support() const {
+    return intersect(factorSupport(lhs), factorSupport(rhs));
+}
+
+Mix::Mix(std::vector<Signal> _signals) {
+    double offset = 0;
+    signals.reserve(_signals.size());
+    expandSum(_signals, signals, offset);
+    if (offset != 0 && !signals.empty())
+        signals[0].bias += offset;
+}
+
+double Mix::sample(double t) const {
+    double out = 0;
+    for (auto& s : signals)
+        out += sampleTerm(s, t);
+    return out;
+}
+
+void Mix::sample(const double* t, double* b, int n) const {
+    if (signals.empty()) {
+        std::fill(b, b + n, 0.0);
+        return;
+    }
+    double tmp[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        double lo, hi;
+        bounds(t + i, m, lo, hi);
+        for (std::size_t k = 0; k < signals.size(); ++k)
+            sampleTerm(signals[k], t + i, b + i, tmp, m, lo, hi, k > 0);
+    }
+}
+
+double Mix::length() const {
+    double len = 0;
+    for (auto& s : signals)
+        len = std::max(len, s.length());
+    return len;
+}
+
+bool Mix::isConstant() const {
+    return std::all_of(signals.begin(), signals.end(), [](const Signal& s) { return s.isConstant(); });
+}
+
+Interval Mix::support() const {
+    double bias = 0;
+    Interval out = {INF, -INF};
+    for (auto& s : signals) {
+        bias += s.bias;
+        out = hull(out, s.support());
+    }
+    return bias == 0 ? out : Interval{-INF, INF};
+}
+
+Modulation::Modulation(std::vector<Signal> _signals) {
+    signals.reserve(_signals.size());
+    expandProduct(_signals, signals);
+}
+
+double Modulation::sample(double t) const {
+    if (outside(support(), t, t))
+        return 0;
+    double out = 1;
+    for (auto& s : signals)
+        out *= s.sample(t);
+    return out;
+}
+
+void Modulation::sample(const double* t, double* b, int n) const {
+    if (signals.empty()) {
+        std::fill(b, b + n, 1.0);
+        return;
+    }
+    const Interval s = support();
+    double tmp[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        double lo, hi;
+        bounds(t + i, m, lo, hi);
+        if (outside(s, lo, hi)) {
+            std::fill(b + i, b + i + m, 0.0);
+            continue;
+        }
+        signals[0].sample(t + i, b + i, m);
+        for (std::size_t k = 1; k < signals.size(); ++k) {
+            signals[k].sample(t + i, tmp, m);
+            for (int j = 0; j < m; ++j)
+                b[i + j] *= tmp[j];
+        }
+    }
+}
+
+double Modulation::length() const {
+    double len = INF;
+    for (auto& s : signals)
+        len = std::min(len, s.length());
+    return len;
+}
+
+bool Modulation::isConstant() const {
+    return std::all_of(signals.begin(), signals.end(), [](const Signal& s) { return s.isConstant(); });
+}
+
+Interval Modulation::support() const {
+    Interval out = {-INF, INF};
+    for (auto& s : signals)
+        out = intersect(out, factorSupport(s));
+    return out;
+}
+
 } // namespace tact
@@ -0,0 +1,553 @@
+#include <Tact/Optimizer.hpp>
+#include <Tact/General.hpp>
+#include <Tact/Operator.hpp>
+#include <Tact/Oscillator.hpp>
+#include <Tact/Envelope.hpp>
+#include <Tact/Process.hpp>
+#include <Tact/Sequence.hpp>
+#include <FastExpression.hpp>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace tact
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// STRUCTURAL EQUALITY
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+bool sameModel(const Signal& a, const Signal& b);
+
+/// Returns true if a and b are structurally identical.
+bool same(const Signal& a, const Signal& b) {
+    return a.gain == b.gain && a.bias == b.bias && sameModel(a, b);
+}
+
+template <typename T, typename F>
+bool sameAs(const Signal& a, const Signal& b, F equal) {
+    return equal(*a.getAs<T>(), *b.getAs<T>());
+}
+
+/// Returns true if the models of a and b are structurally identical, ignoring gain and bias.
+bool sameModel(const Signal& a, const Signal& b) {
+    auto id = a.typeId();
+    if (id != b.typeId())
+        return false;
+    if (a.get() == b.get())
+        return true;
+    if (id == typeid(Time))
+        return true;
+    if (id == typeid(Scalar))
+        return sameAs<Scalar>(a, b, [](auto& x, auto& y) { return x.value == y.value; });
+    if (id == typeid(Ramp))
+        return sameAs<Ramp>(a, b, [](auto& x, auto& y) { return x.initial == y.initial && x.rate == y.rate && x.duration == y.duration; });
+    if (id == typeid(Sum))
+        return sameAs<Sum>(a, b, [](auto& x, auto& y) { return same(x.lhs, y.lhs) && same(x.rhs, y.rhs); });
+    if (id == typeid(Product))
+        return sameAs<Product>(a, b, [](auto& x, auto& y) { return same(x.lhs, y.lhs) && same(x.rhs, y.rhs); });
+    if (id == typeid(Mix) || id == typeid(Modulation)) {
+        auto& x = ((const INaryOperator*)a.get())->signals;
+        auto& y = ((const INaryOperator*)b.get())->signals;
+        return std::equal(x.begin(), x.end(), y.begin(), y.end(), same);
+    }
+    if (id == typeid(Sine) || id == typeid(Square) || id == typeid(Saw) || id == typeid(Triangle))
+        return same(((const IOscillator*)a.get())->x, ((const IOscillator*)b.get())->x);
+    if (id == typeid(WavetableSine) || id == typeid(WavetableSquare) || id == typeid(WavetableSaw) || id == typeid(WavetableTriangle))
+        return ((const IWavetable*)a.get())->interpolation == ((const IWavetable*)b.get())->interpolation &&
+               same(((const IOscillator*)a.get())->x, ((const IOscillator*)b.get())->x);
+    if (id == typeid(Pwm))
+        return sameAs<Pwm>(a, b, [](auto& x, auto& y) { return x.frequency == y.frequency && x.dutyCycle == y.dutyCycle; });
+    if (id == typeid(Envelope))
+        return sameAs<Envelope>(a, b, [](auto& x, auto& y) { return x.duration == y.duration && x.amplitude == y.amplitude; });
+    if (id == typeid(ExponentialDecay))
+        return sameAs<ExponentialDecay>(a, b, [](auto& x, auto& y) { return x.amplitude == y.amplitude && x.decay == y.decay; });
+    if (id == typeid(SignalEnvelope))
+        return sameAs<SignalEnvelope>(a, b, [](auto& x, auto& y) { return x.duration == y.duration && x.amplitude == y.amplitude && same(x.signal, y.signal); });
+    if (id == typeid(Stretcher))
+        return sameAs<Stretcher>(a, b, [](auto& x, auto& y) { return x.factor == y.factor && same(x.signal, y.signal); });
+    if (id == typeid(Reverser))
+        return sameAs<Reverser>(a, b, [](auto& x, auto& y) { return same(x.signal, y.signal); });
+    if (id == typeid(Repeater))
+        return sameAs<Repeater>(a, b, [](auto& x, auto& y) { return x.repetitions == y.repetitions && x.delay == y.delay && same(x.signal, y.signal); });
+    if (id == typeid(TimeMap))
+        return sameAs<TimeMap>(a, b, [](auto& x, auto& y) { 
+            auto stage = [](const TimeMap::Stage& p, const TimeMap::Stage& q) {
+                return p.periodic == q.periodic && p.scale == q.scale && p.offset == q.offset && p.lo == q.lo && 
+                       p.hi == q.hi && p.period == q.period && p.active == q.active && p.end == q.end;
+            };
+            return x.duration == y.duration && same(x.signal, y.signal) &&
+                   std::equal(x.stages.begin(), x.stages.end(), y.stages.begin(), y.stages.end(), stage);
+        });
+    return false;
+}
+
+/// Returns true if a Signal is a constant (i.e. a Scalar).
+bool isConstant(const Signal& sig) {
+    return sig.isType<Scalar>();
+}
+
+/// Returns the value of a constant Signal.
+double constantValue(const Signal& sig) {
+    return sig.getAs<Scalar>()->value * sig.gain + sig.bias;
+}
+
+/// Makes a constant Signal.
+Signal constant(double value) {
+    return Scalar(value);
+}
+
+} // namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// OPTIMIZER
+///////////////////////////////////////////////////////////////////////////////
+
+/// Rewrites Signal graphs bottom up. Every rewrite preserves both sampled values and length.
+class Optimizer {
+public:
+
+    Signal run(const Signal& sig) {
+        // any constant subgraph of infinite length is a Scalar
+        if (sig.isConstant() && sig.length() == INF)
+            return constant(sig.sample(0));
+        auto id = sig.typeId();
+        if (id == typeid(Expression)) {
+            Signal lowered = lowerExpression(sig);
+            return lowered.isType<Expression>() ? sig : run(lowered);
+        }
+        if (id == typeid(Sum) || id == typeid(Mix))
+            return sum(sig);
+        if (id == typeid(Product) || id == typeid(Modulation))
+            return product(sig);
+        if (id == typeid(Sine))
+            return oscillator<Sine>(sig);
+        if (id == typeid(Square))
+            return oscillator<Square>(sig);
+        if (id == typeid(Saw))
+            return oscillator<Saw>(sig);
+        if (id == typeid(Triangle))
+            return oscillator<Triangle>(sig);
+        if (id == typeid(WavetableSine))
+            return oscillator<WavetableSine>(sig);
+        if (id == typeid(WavetableSquare))
+            return oscillator<WavetableSquare>(sig);
+        if (id == typeid(WavetableSaw))
+            return oscillator<WavetableSaw>(sig);
+        if (id == typeid(WavetableTriangle))
+            return oscillator<WavetableTriangle>(sig);
+        if (id == typeid(Stretcher) || id == typeid(Reverser) || id == typeid(Repeater) || id == typeid(TimeMap))
+            return timeMap(sig);
+        if (id == typeid(SignalEnvelope)) {
+            SignalEnvelope env = *sig.getAs<SignalEnvelope>();
+            env.signal = run(env.signal);
+            return make(std::move(env), sig.gain, sig.bias);
+        }
+        if (id == typeid(Sequence)) {
+            auto& seq = *sig.getAs<Sequence>();
+            Sequence opt;
+            // optimize each shared instance once, and share the result in turn
+            std::unordered_map<const Signal*, std::shared_ptr<const Signal>> instances;
+            for (int i = 0; i < seq.keyCount(); ++i) {
+                auto& key = seq.getKey(i);
+                auto& instance = instances[key.signal.get()];
+                if (!instance)
+                    instance = std::make_shared<const Signal>(run(*key.signal));
+                opt.insert(Sequence::Key{key.t, key.gain, instance});
+            }
+            opt.head = seq.head;
+            return make(std::move(opt), sig.gain, sig.bias);
+        }
+        return sig;
+    }
+
+private:
+
+    /// Makes a Signal from a rewritten model.
+    template <typename T>
+    static Signal make(T model, double gain, double bias) {
+        Signal out(std::move(model));
+        out.gain = gain;
+        out.bias = bias;
+        return out;
+    }
+
+    /// Moves the gain (and bias if allowed) of an input Signal into an output gain and bias.
+    static void hoist(Signal& input, double& gain, double& bias, bool withBias) {
+        if (withBias) {
+            bias += gain * input.bias;
+            input.bias = 0;
+        }
+        else if (input.bias != 0)
+            return;
+        gain *= input.gain;
+        input.gain = 1;
+    }
+
+    /// An oscillator of a constant is a constant.
+    template <typename T>
+    Signal oscillator(const Signal& sig) {
+        T osc = *sig.getAs<T>();
+        osc.x = run(osc.x);
+        if (isConstant(osc.x)) 
+            return constant(osc.sample(0) * sig.gain + sig.bias);
+        return make(std::move(osc), sig.gain, sig.bias);
+    }
+
+    /// Appends a Stage to a chain, composing it with a preceding affine Stage.
+    static void appendStage(std::vector<TimeMap::Stage>& stages, const TimeMap::Stage& s) {
+        if (!s.periodic && s.scale == 1 && s.offset == 0 && s.lo == -INF && s.hi == INF)
+            return;
+        if (!s.periodic && !stages.empty() && !stages.back().periodic && std::isfinite(s.scale) && s.scale != 0) {
+            // s(clamp(x, lo, hi)) = clamp(s(x), s(lo), s(hi)) for the affine part of s, and nested
+            // clamps combine into one
+            auto& a = stages.back();
+            double l = s.scale * a.lo + s.offset;
+            double h = s.scale * a.hi + s.offset;
+            if (s.scale < 0)
+                std::swap(l, h);
+            a.scale  = s.scale * a.scale;
+            a.offset = s.scale * a.offset + s.offset;
+            a.lo     = clamp(l, s.lo, s.hi);
+            a.hi     = clamp(h, s.lo, s.hi);
+            return;
+        }
+        stages.push_back(s);
+    }
+
+    /// Fuses a chain of nested Stretchers, Reversers, Repeaters and TimeMaps into one TimeMap.
+    Signal timeMap(const Signal& sig) {
+        TimeMap map;
+        map.duration = sig.length();
+        double gain  = sig.gain;
+        double bias  = sig.bias;
+        bool masked  = false; // does a periodic stage zero the output of the next node?
+        Signal node  = sig;
+        node.gain = 1;
+        node.bias = 0;
+        while (true) {
+            auto id = node.typeId();
+            Signal next;
+            if (id == typeid(Stretcher)) {
+                auto str = node.getAs<Stretcher>();
+                appendStage(map.stages, TimeMap::Stage::affine(1.0 / str->factor, 0));
+                next = str->signal;
+            }
+            else if (id == typeid(Reverser)) {
+                auto rev = node.getAs<Reverser>();
+                double l = rev->signal.length();
+                l = l == INF ? 1000000000 : l;
+                appendStage(map.stages, TimeMap::Stage::affine(-1, l, 0, 1000000000));
+                next = rev->signal;
+            }
+            else if (id == typeid(Repeater)) {
+                auto rep = node.getAs<Repeater>();
+                double sigLen = rep->signal.length();
+                double intLen = sigLen + rep->delay;
+                double maxLen = sigLen * rep->repetitions + rep->delay * (rep->repetitions - 1);
+                appendStage(map.stages, TimeMap::Stage::repeat(intLen, sigLen, maxLen));
+                masked = true;
+                next = rep->signal;
+            }
+            else if (id == typeid(TimeMap)) {
+                auto inner = node.getAs<TimeMap>();
+                for (auto& s : inner->stages) {
+                    appendStage(map.stages, s);
+                    masked = masked || s.periodic;
+                }
+                next = inner->signal;
+            }
+            else
+                break;
+            // the next node's gain can always be moved outside, but its bias only if unmasked
+            if (next.bias != 0 && masked) {
+                node = std::move(next);
+                break;
+            }
+            bias += gain * next.bias;
+            gain *= next.gain;
+            next.gain = 1;
+            next.bias = 0;
+            node = std::move(next);
+        }
+        Signal inner = run(node);
+        Signal out;
+        if (map.stages.empty())
+            out = std::move(inner);
+        else {
+            map.signal = std::move(inner);
+            out = std::move(map);
+        }
+        out.gain *= gain;
+        out.bias  = out.bias * gain + bias;
+        return out;
+    }
+
+    /// Flattens nested Sums and Mixes into terms with bias zero. Terms with equal models are merged
+    /// and constants are folded into a single bias.
+    struct Terms {
+        std::vector<Signal> terms;
+        double bias       = 0;
+        bool   hasDropped = false; ///< were any terms folded into bias?
+        double droppedLen = 0;     ///< length of the longest term folded into bias
+        Signal dropped;            ///< the longest term folded into bias, zeroed
+    };
+
+    void flattenSum(const Signal& sig, double scale, Terms& out, bool optimized) {
+        if (sig.isType<Sum>()) {
+            out.bias += scale * sig.bias;
+            auto op = sig.getAs<Sum>();
+            flattenSum(op->lhs, scale * sig.gain, out, optimized);
+            flattenSum(op->rhs, scale * sig.gain, out, optimized);
+            return;
+        }
+        if (sig.isType<Mix>()) {
+            out.bias += scale * sig.bias;
+            for (auto& term : sig.getAs<Mix>()->signals)
+                flattenSum(term, scale * sig.gain, out, optimized);
+            return;
+        }
+        if (!optimized) {
+            Signal opt = run(sig);
+            if (opt.isType<Sum>() || opt.isType<Mix>()) 
+                return flattenSum(opt, scale, out, true);
+            return addTerm(std::move(opt), scale, out);
+        }
+        addTerm(sig, scale, out);
+    }
+
+    void addTerm(Signal term, double scale, Terms& out) {
+        out.bias += scale * term.bias;
+        term.bias = 0;
+        term.gain *= scale;
+        if (isConstant(term)) {
+            out.bias += constantValue(term);
+            dropTerm(term, out);
+            return;
+        }
+        for (auto& t : out.terms) {
+            if (sameModel(t, term)) {
+                t.gain += term.gain;
+                return;
+            }
+        }
+        out.terms.push_back(std::move(term));
+    }
+
+    void dropTerm(const Signal& term, Terms& out) {
+        double len = term.length();
+        if (!out.hasDropped || len > out.droppedLen) {
+            out.hasDropped = true;
+            out.droppedLen = len;
+            // a zeroed Scalar is cheaper to keep than a zeroed anything else
+            out.dropped = isConstant(term) ? constant(0) : term;
+            out.dropped.gain = 0;
+            out.dropped.bias = 0;
+        }
+    }
+
+    Signal sum(const Signal& sig) {
+        Terms t;
+        flattenSum(sig, 1, t, false);
+        // terms which cancelled out are zero, but still contribute their length
+        std::vector<Signal> terms;
+        for (auto& term : t.terms) {
+            if (term.gain == 0)
+                dropTerm(term, t);
+            else
+                terms.push_back(std::move(term));
+        }
+        double len = 0;
+        for (auto& term : terms)
+            len = std::max(len, term.length());
+        // keep one dropped term if the Sum's length depended on it
+        if (t.hasDropped && (terms.empty() || t.droppedLen > len)) {
+            if (terms.empty() && isConstant(t.dropped))
+                return constant(t.bias);
+            terms.push_back(t.dropped);
+        }
+        // an empty Mix, or one of only empty Mixes, is its bias
+        if (terms.empty())
+            return constant(t.bias);
+        // hoist a gain common to all terms
+        double gain = terms[0].gain;
+        for (auto& term : terms) {
+            if (term.gain != gain) {
+                gain = 1;
+                break;
+            }
+        }
+        if (gain != 1 && gain != 0) {
+            for (auto& term : terms) 
+                term.gain = 1;
+        }
+        else 
+            gain = 1;
+        Signal out = terms.size() == 1 ? terms[0] 
+                   : terms.size() == 2 ? Signal(Sum(terms[0], terms[1])) 
+                   : Signal(Mix(std::move(terms)));
+        out.gain *= gain;
+        out.bias += t.bias;
+        return out;
+    }
+
+    /// Flattens nested Products and Modulations into factors with gain one (where possible), accumulating
+    /// a single gain. Constant factors are folded into the gain.
+    void flattenProduct(const Signal& sig, double& gain, std::vector<Signal>& factors, std::vector<Signal>& constants, bool optimized) {
+        if (sig.isType<Product>() && sig.bias == 0) {
+            gain *= sig.gain;
+            auto op = sig.getAs<Product>();
+            flattenProduct(op->lhs, gain, factors, constants, optimized);
+            flattenProduct(op->rhs, gain, factors, constants, optimized);
+            return;
+        }
+        if (sig.isType<Modulation>() && sig.bias == 0) {
+            gain *= sig.gain;
+            for (auto& factor : sig.getAs<Modulation>()->signals)
+                flattenProduct(factor, gain, factors, constants, optimized);
+            return;
+        }
+        if (!optimized) {
+            Signal opt = run(sig);
+            return flattenProduct(opt, gain, factors, constants, true);
+        }
+        if (isConstant(sig))
+            gain *= constantValue(sig);
+        else if (sig.gain == 0)
+            constants.push_back(sig);
+        else if (sig.bias == 0) {
+            gain *= sig.gain;
+            Signal factor = sig;
+            factor.gain = 1;
+            factors.push_back(std::move(factor));
+        }
+        else
+            factors.push_back(sig);
+    }
+
+    Signal product(const Signal& sig) {
+        double gain = sig.gain;
+        std::vector<Signal> factors, constants;
+        if (sig.isType<Product>()) {
+            auto op = sig.getAs<Product>();
+            flattenProduct(op->lhs, gain, factors, constants, false);
+            flattenProduct(op->rhs, gain, factors, constants, false);
+        }
+        else {
+            for (auto& factor : sig.getAs<Modulation>()->signals)
+                flattenProduct(factor, gain, factors, constants, false);
+        }
+        double len = INF;
+        for (auto& f : factors)
+            len = std::min(len, f.length());
+        // constant factors of zero gain can be folded unless they determine the length
+        for (auto& c : constants) {
+            if (c.length() >= len) 
+                gain *= c.bias;
+            else
+                factors.push_back(c);
+        }
+        if (gain == 0) {
+            double l = sig.length();
+            Signal out = l == INF ? constant(0) : Signal(Envelope(l, 0));
+            out.bias = sig.bias;
+            return out;
+        }
+        if (factors.empty())
+            return constant(gain + sig.bias);
+        Signal out = factors[0];
+        if (factors.size() == 1) 
+            out *= gain;
+        else {
+            out = factors.size() == 2 ? Signal(Product(factors[0], factors[1])) : Signal(Modulation(std::move(factors)));
+            out.gain = gain;
+        }
+        out.bias += sig.bias;
+        return out;
+    }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+
+Signal optimize(const Signal& signal) {
+    Optimizer opt;
+    return opt.run(signal);
+}
+
+Signal lowerExpression(const Signal& signal) {
+    if (!signal.isType<Expression>())
+        return signal;
+    FastExpression::Code code;
+    if (!FastExpression::Parser(signal.getAs<Expression>()->getExpression()).parse(code))
+        return signal;
+    using FastExpression::Op;
+    // evaluate the postfix code on a stack of constants and Signals
+    struct Value {
+        bool   constant;
+        double k;
+        Signal sig;
+    };
+    auto toSignal = [](const Value& v) { return v.constant ? Signal(Scalar(v.k)) : v.sig; };
+    std::vector<Value> stack;
+    for (auto& ins : code.ops) {
+        if (ins.op == Op::Const) {
+            stack.push_back({true, ins.k, Signal()});
+            continue;
+        }
+        if (ins.op == Op::Time) {
+            stack.push_back({false, 0, Time()});
+            continue;
+        }
+        if (FastExpression::arity(ins.op) == 1) {
+            // constant operands were folded by the parser, so a is a Signal
+            Value& a = stack.back();
+            if (ins.op == Op::Neg)
+                a.sig = -a.sig;
+            else if (ins.op == Op::Sin)
+                a.sig = Sine(a.sig);
+            else if (ins.op == Op::Cos)
+                a.sig = Sine(a.sig + HALF_PI);
+            else
+                return signal;
+            continue;
+        }
+        Value b = stack.back();
+        stack.pop_back();
+        Value& a = stack.back();
+        switch (ins.op) {
+            case Op::Add:
+                a.sig = a.constant ? a.k + b.sig : b.constant ? a.sig + b.k : a.sig + b.sig;
+                break;
+            case Op::Sub:
+                a.sig = a.constant ? a.k - b.sig : b.constant ? a.sig - b.k : a.sig - b.sig;
+                break;
+            case Op::Mul:
+                a.sig = a.constant ? a.k * b.sig : b.constant ? a.sig * b.k : a.sig * b.sig;
+                break;
+            case Op::Div:
+                if (!b.constant)
+                    return signal;
+                a.sig = a.sig * (1.0 / b.k);
+                break;
+            case Op::Pow: {
+                // small integer powers are repeated Products
+                if (a.constant || !b.constant || b.k != std::floor(b.k) || b.k < 1 || b.k > 4)
+                    return signal;
+                Signal base = a.sig;
+                for (int i = 1; i < (int)b.k; ++i)
+                    a.sig = a.sig * base;
+                break;
+            }
+            default:
+                return signal;
+        }
+        a.constant = false;
+    }
+    return toSignal(stack.back()) * signal.gain + signal.bias;
+}
+
+} // namespace tact
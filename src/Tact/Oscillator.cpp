@@ -1,9 +1,204 @@
 #include <Tact/Oscillator.hpp>
 #include <Tact/Operator.hpp>
+#include <FastMath.hpp>
+#include <algorithm>
+#include <limits>
+#include <array>
+#include <vector>
 
 namespace tact
 {
 
+namespace {
+
+/// Minimum block size for which the phase kernels are worthwhile
+constexpr int MIN_KERNEL_BLOCK = 4;
+
+/// Extracts phase = a*t^2 + b*t + c from Time or a Product of Times, or returns false.
+bool polynomialPhase(const Signal& x, double& a, double& b, double& c) {
+    if (x.isType<Time>()) {
+        a = 0;
+        b = x.gain;
+        c = x.bias;
+        return true;
+    }
+    if (x.isType<Product>()) {
+        auto p = x.getAs<Product>();
+        if (!p->lhs.isType<Time>() || !p->rhs.isType<Time>())
+            return false;
+        // (gl*t + bl) * (gr*t + br) * g + o
+        double gl = p->lhs.gain, bl = p->lhs.bias;
+        double gr = p->rhs.gain, br = p->rhs.bias;
+        a = x.gain * gl * gr;
+        b = x.gain * (gl * br + bl * gr);
+        c = x.gain * bl * br + x.bias;
+        return true;
+    }
+    return false;
+}
+
+/// Returns true if t[i] == t[0] + i * dt up to rounding of the times themselves
+bool uniform(const double* t, int n, double& dt) {
+    dt = (t[n-1] - t[0]) / (n - 1);
+    const double tol = 1e-9 * std::abs(dt);
+    const double eps = 4 * std::numeric_limits<double>::epsilon();
+    for (int i = 1; i < n - 1; ++i) {
+        if (std::abs(t[i] - (t[0] + i * dt)) > tol + eps * std::abs(t[i]))
+            return false;
+    }
+    return true;
+}
+
+/// Wraps phase to [0, 2pi)
+inline double wrap(double p) {
+    p -= TWO_PI * std::floor(p * (1.0 / TWO_PI));
+    return p < TWO_PI ? p : 0.0;
+}
+
+/// Number of entries in one period of a wavetable
+constexpr int TABLE_SIZE = 4096;
+
+/// One period of a waveform, with one guard entry before and three after it for interpolation
+struct Wavetable {
+    template <typename F>
+    Wavetable(F f) {
+        for (int i = -1; i < TABLE_SIZE + 3; ++i)
+            entries[i + 1] = static_cast<float>(f(TWO_PI * i / TABLE_SIZE));
+    }
+    /// Builds the table from the TABLE_SIZE samples of one period
+    Wavetable(const std::vector<double>& period) {
+        for (int i = -1; i < TABLE_SIZE + 3; ++i)
+            entries[i + 1] = static_cast<float>(period[(i + TABLE_SIZE) % TABLE_SIZE]);
+    }
+    const float* data() const { return entries.data() + 1; }
+    std::array<float, TABLE_SIZE + 4> entries;
+};
+
+/// Number of band-limited tables per waveform, the last holding harmonics up to 512
+constexpr int MIP_LEVELS = 10;
+
+/// Band-limited tables of a waveform, where table k holds its Fourier series up to harmonic 2^k
+struct Mipmap {
+    /// Builds the tables from the sine series coefficient(h) of each harmonic h
+    template <typename F>
+    Mipmap(F coefficient) {
+        std::vector<double> sines(TABLE_SIZE), period(TABLE_SIZE, 0.0);
+        for (int i = 0; i < TABLE_SIZE; ++i)
+            sines[i] = std::sin(TWO_PI * i / TABLE_SIZE);
+        levels.reserve(MIP_LEVELS);
+        int h = 1;
+        for (int k = 0; k < MIP_LEVELS; ++k) {
+            // each level adds the harmonics above those of the previous one
+            for (; h <= (1 << k); ++h) {
+                const double c = coefficient(h);
+                if (c == 0)
+                    continue;
+                for (int i = 0; i < TABLE_SIZE; ++i)
+                    period[i] += c * sines[(h * i) & (TABLE_SIZE - 1)];
+            }
+            levels.emplace_back(period);
+        }
+        for (int k = 0; k < MIP_LEVELS; ++k)
+            tables[k] = levels[k].data();
+    }
+    std::vector<Wavetable> levels;
+    std::array<const float*, MIP_LEVELS> tables;
+};
+
+/// Returns the highest level whose top harmonic stays below Nyquist at inc radians per sample
+inline int mipLevel(double inc, int levels) {
+    int k = levels - 1;
+    while (k > 0 && (1 << k) * inc >= PI)
+        --k;
+    return k;
+}
+
+/// Reads table at fractional index u in [0, TABLE_SIZE]
+inline double read(const float* table, double u, bool cubic) {
+    int i = static_cast<int>(u);
+    double f = u - i;
+    if (!cubic)
+        return table[i] + f * (table[i+1] - table[i]);
+    // Catmull-Rom spline
+    double y0 = table[i-1], y1 = table[i], y2 = table[i+1], y3 = table[i+2];
+    double c1 = 0.5 * (y2 - y0);
+    double c2 = y0 - 2.5 * y1 + 2 * y2 - 0.5 * y3;
+    double c3 = 0.5 * (y3 - y0) + 1.5 * (y1 - y2);
+    return ((c3 * f + c2) * f + c1) * f + y1;
+}
+
+/// Scales phase in radians to table index
+constexpr double TABLE_SCALE = TABLE_SIZE * 0.5 * INV_PI;
+
+} // private namespace
+
+bool IOscillator::sampleKernel(Shape shape, const double* t, double* b, int n) const {
+    double pa, pb, pc, dt;
+    if (n < MIN_KERNEL_BLOCK || !polynomialPhase(x, pa, pb, pc) || !uniform(t, n, dt))
+        return false;
+    // phase(t0 + k*dt) = p0 + sum of increments d0 + j*dd for j < k
+    const double t0 = t[0];
+    double p  = wrap((pa * t0 + pb) * t0 + pc);
+    double d  = wrap(pa * (2 * t0 + dt) * dt + pb * dt);
+    double dd = wrap(2 * pa * dt * dt);
+#if defined(SYNTACTS_USE_FLOAT) && defined(__AVX2__)
+    // closed form phases instead of serial recurrences, so that the shapes are evaluated by 
+    // the vectorized single precision kernels (re-anchored every block to keep phases small).
+    // Only worthwhile with at least 8 float lanes, since the recurrences are cheaper than 4.
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        const int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        for (int j = 0; j < m; ++j)
+            b[i + j] = p + j * d + 0.5 * (j * (j - 1)) * dd;
+        p = wrap(p + m * d + 0.5 * (m * (m - 1)) * dd);
+        d = wrap(d + m * dd);
+    }
+    switch (shape) {
+        case Shape::Sine:   FastMath::sin(b, b, n); break;
+        case Shape::Square: FastMath::square(b, b, n); break;
+        case Shape::Saw:    FastMath::saw(b, b, n); break;
+        default:            FastMath::triangle(b, b, n); break;
+    }
+#else
+    if (shape == Shape::Sine) {
+        // complex rotation z *= w, w *= v
+        double zr = std::cos(p),  zi = std::sin(p);
+        double wr = std::cos(d),  wi = std::sin(d);
+        double vr = std::cos(dd), vi = std::sin(dd);
+        for (int i = 0; i < n; ++i) {
+            b[i] = zi;
+            double r = zr * wr - zi * wi;
+            zi = zr * wi + zi * wr;
+            zr = r;
+            if (pa != 0) {
+                r  = wr * vr - wi * vi;
+                wi = wr * vi + wi * vr;
+                wr = r;
+            }
+        }
+        return true;
+    }
+    // wrapped phase accumulator, with closed forms of the scalar definitions over [0, 2pi)
+    for (int i = 0; i < n; ++i) {
+        switch (shape) {
+            case Shape::Square:
+                b[i] = p > 0 && p < PI ? 1.0 : -1.0;
+                break;
+            case Shape::Saw:
+                b[i] = p * INV_PI - 1;
+                break;
+            default: // Triangle
+                b[i] = 2 * INV_PI * (p < HALF_PI ? p : p < 3 * HALF_PI ? PI - p : p - TWO_PI);
+                break;
+        }
+        p += d;
+        d += dd;
+        p = p < TWO_PI ? p : wrap(p);
+        d = d < TWO_PI ? d : d - TWO_PI;
+    }
+#endif
+    return true;
+}
+
 IOscillator::IOscillator() :
     IOscillator(100)
 { }
@@ -24,6 +219,127 @@ IOscillator::IOscillator(double hertz, Signal modulation, double index) :
     x(std::move(TWO_PI * hertz * Time() + index * modulation))
 { }
 
+void Sine::sample(const double* t, double* b, int n) const {
+    if (sampleKernel(Shape::Sine, t, b, n))
+        return;
+    x.sample(t, b, n);
+    FastMath::sin(b, b, n);
+}
+
+void Square::sample(const double* t, double* b, int n) const {
+    if (sampleKernel(Shape::Square, t, b, n))
+        return;
+    x.sample(t, b, n);
+    FastMath::square(b, b, n);
+}
+
+void Saw::sample(const double* t, double* b, int n) const {
+    if (sampleKernel(Shape::Saw, t, b, n))
+        return;
+    x.sample(t, b, n);
+    FastMath::saw(b, b, n);
+}
+
+void Triangle::sample(const double* t, double* b, int n) const {
+    if (sampleKernel(Shape::Triangle, t, b, n))
+        return;
+    x.sample(t, b, n);
+    FastMath::triangle(b, b, n);
+}
+
+double IWavetable::lookup(const float* const* tables, int levels, double t) const {
+    double u = x.sample(t) * TABLE_SCALE;
+    u -= TABLE_SIZE * std::floor(u * (1.0 / TABLE_SIZE));
+    const bool cubic = interpolation == Interpolation::Cubic || interpolation == Interpolation::Sinc;
+    return read(tables[levels - 1], u, cubic);
+}
+
+void IWavetable::lookup(const float* const* tables, int levels, const double* t, double* b, int n) const {
+    x.sample(t, b, n);
+    const bool cubic = interpolation == Interpolation::Cubic || interpolation == Interpolation::Sinc;
+    const float* table = tables[levels - 1];
+    if (levels > 1 && n > 1) {
+        double inc = 0;
+        for (int i = 1; i < n; ++i)
+            inc = std::max(inc, std::abs(b[i] - b[i-1]));
+        table = tables[mipLevel(inc, levels)];
+    }
+    if (!FastMath::inRange(b, n, FastMath::TRIG_LIMIT)) {
+        for (int i = 0; i < n; ++i) {
+            double u = b[i] * TABLE_SCALE;
+            u -= TABLE_SIZE * std::floor(u * (1.0 / TABLE_SIZE));
+            b[i] = read(table, u, cubic);
+        }
+        return;
+    }
+    for (int i = 0; i < n; ++i) {
+        double u = b[i] * TABLE_SCALE;
+        u -= TABLE_SIZE * FastMath::round(u * (1.0 / TABLE_SIZE));
+        u += u < 0 ? TABLE_SIZE : 0;
+        b[i] = read(table, u, cubic);
+    }
+}
+
+namespace {
+
+const float* const* sineTable() {
+    static const Wavetable table([](double p) { return std::sin(p); });
+    static const float* const tables[] = { table.data() };
+    return tables;
+}
+
+const float* const* squareTable() {
+    // 4/pi * sum of sin(h*p)/h over odd h
+    static const Mipmap mipmap([](int h) { return h % 2 ? 4 * INV_PI / h : 0.0; });
+    return mipmap.tables.data();
+}
+
+const float* const* sawTable() {
+    // -2/pi * sum of sin(h*p)/h, rising from -1 to 1 over each period
+    static const Mipmap mipmap([](int h) { return -2 * INV_PI / h; });
+    return mipmap.tables.data();
+}
+
+const float* const* triangleTable() {
+    // 8/pi^2 * sum of (-1)^((h-1)/2) * sin(h*p)/h^2 over odd h
+    static const Mipmap mipmap([](int h) { return h % 2 ? (h % 4 == 1 ? 8 : -8) * INV_PI * INV_PI / (h * h) : 0.0; });
+    return mipmap.tables.data();
+}
+
+} // private namespace
+
+double WavetableSine::sample(double t) const {
+    return lookup(sineTable(), 1, t);
+}
+
+void WavetableSine::sample(const double* t, double* b, int n) const {
+    lookup(sineTable(), 1, t, b, n);
+}
+
+double WavetableSquare::sample(double t) const {
+    return lookup(squareTable(), MIP_LEVELS, t);
+}
+
+void WavetableSquare::sample(const double* t, double* b, int n) const {
+    lookup(squareTable(), MIP_LEVELS, t, b, n);
+}
+
+double WavetableSaw::sample(double t) const {
+    return lookup(sawTable(), MIP_LEVELS, t);
+}
+
+void WavetableSaw::sample(const double* t, double* b, int n) const {
+    lookup(sawTable(), MIP_LEVELS, t, b, n);
+}
+
+double WavetableTriangle::sample(double t) const {
+    return lookup(triangleTable(), MIP_LEVELS, t);
+}
+
+void WavetableTriangle::sample(const double* t, double* b, int n) const {
+    lookup(triangleTable(), MIP_LEVELS, t, b, n);
+}
+
 Pwm::Pwm(double _frequency, double _dutyCycle) :
     frequency(_frequency), 
     dutyCycle(clamp01(_dutyCycle))
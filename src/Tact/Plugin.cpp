@@ -0,0 +1,368 @@
+#include <Tact/Plugin.hpp>
+#include <Tact/General.hpp>
+#include <Tact/Operator.hpp>
+#include <Tact/Oscillator.hpp>
+#include <Tact/Envelope.hpp>
+#include <Tact/Process.hpp>
+#include <Tact/Sequence.hpp>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace tact
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// PLUGIN
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+    using SampleFunc = double(*)(double);
+    using BlockFunc  = void(*)(const double*, double*, int);
+    using LengthFunc = double(*)();
+}
+
+/// An open shared library, closed when the last Plugin referencing it is destroyed.
+struct Plugin::Library {
+    ~Library() {
+#ifdef _WIN32
+        FreeLibrary((HMODULE)handle);
+#else
+        dlclose(handle);
+#endif
+    }
+    void*      handle = nullptr;
+    SampleFunc sample = nullptr;
+    BlockFunc  block  = nullptr;
+    double     length = 0;
+};
+
+Plugin::Plugin() 
+{ }
+
+Plugin::Plugin(const std::string& path) {
+    open(path);
+}
+
+bool Plugin::open(const std::string& path) {
+    m_lib  = nullptr;
+    m_path = path;
+#ifdef _WIN32
+    void* handle = (void*)LoadLibraryA(path.c_str());
+    auto symbol  = [&](const char* name) { return (void*)GetProcAddress((HMODULE)handle, name); };
+#else
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    auto symbol  = [&](const char* name) { return dlsym(handle, name); };
+#endif
+    if (!handle)
+        return false;
+    auto lib    = std::make_shared<Library>();
+    lib->handle = handle;
+    lib->sample = (SampleFunc)symbol("tact_plugin_sample");
+    lib->block  = (BlockFunc)symbol("tact_plugin_sample_block");
+    auto length = (LengthFunc)symbol("tact_plugin_length");
+    if (!lib->sample || !lib->block || !length)
+        return false;
+    lib->length = length();
+    m_lib = std::move(lib);
+    return true;
+}
+
+bool Plugin::isOpen() const {
+    return m_lib != nullptr;
+}
+
+const std::string& Plugin::getPath() const {
+    return m_path;
+}
+
+double Plugin::sample(double t) const {
+    return m_lib ? m_lib->sample(t) : 0;
+}
+
+void Plugin::sample(const double* t, double* b, int n) const {
+    if (m_lib)
+        m_lib->block(t, b, n);
+    else {
+        for (int i = 0; i < n; ++i)
+            b[i] = 0;
+    }
+}
+
+double Plugin::length() const {
+    return m_lib ? m_lib->length : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// CODE GENERATION
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/// Curve implementations that can be emitted, keyed by Curve::name (see Curve.cpp).
+const std::map<std::string, std::string>& curveBodies() {
+    static std::map<std::string, std::string> bodies = {
+        {"Instant",             "return 1;"},
+        {"Delayed",             "return t < 1 ? 0 : 1;"},
+        {"Linear",              "return t;"},
+        {"Smoothstep",          "return t * t * (3.0f - 2.0f * t);"},
+        {"Smootherstep",        "return t * t * t * (t * (t * 6.0f - 15.0f) + 10.0f);"},
+        {"Smootheststep",       "return t * t * t * t * (t * (t * (t * -20.0f + 70.0f) - 84.0f) + 35.0f);"},
+        {"Quadratic::In",       "return t * t;"},
+        {"Quadratic::Out",      "return t * (2.0f - t);"},
+        {"Quadratic::InOut",    "t *= 2.0f; if (t < 1.0f) return 0.5f * t * t; t -= 1.0f; return -0.5f * (t * (t - 2.0f) - 1.0f);"},
+        {"Cubic::In",           "return t * t * t;"},
+        {"Cubic::Out",          "t -= 1.0f; return t * t * t + 1.0f;"},
+        {"Cubic::InOut",        "t *= 2.0f; if (t < 1.0f) return 0.5f * t * t * t; t -= 2.0f; return 0.5f * (t * t * t + 2.0f);"},
+        {"Sinusoidal::In",      "return 1.0f - std::cos(t * HALF_PI);"},
+        {"Sinusoidal::Out",     "return std::sin(t * HALF_PI);"},
+        {"Sinusoidal::InOut",   "return -0.5f * (std::cos(PI * t) - 1.0f);"}
+    };
+    return bodies;
+}
+
+/// Emits a flat C++ implementation of a Signal graph, one inline function per unique node.
+class Generator {
+public:
+
+    bool run(const Signal& signal, std::ostream& out) {
+        int root = node(signal);
+        if (root < 0)
+            return false;
+        out << "// Generated by Syntacts " << syntactsVersion() << " (tact::codegen). Do not edit.\n\n";
+        out << "#include <cmath>\n#include <limits>\n\n";
+        out << "#ifdef _WIN32\n#define TACT_PLUGIN_EXPORT extern \"C\" __declspec(dllexport)\n";
+        out << "#else\n#define TACT_PLUGIN_EXPORT extern \"C\" __attribute__((visibility(\"default\")))\n#endif\n\n";
+        out << "namespace {\n\n";
+        out << "constexpr double PI      = " << lit(PI) << ";\n";
+        out << "constexpr double HALF_PI = " << lit(HALF_PI) << ";\n";
+        out << "constexpr double INV_PI  = " << lit(INV_PI) << ";\n";
+        out << "constexpr double INF     = std::numeric_limits<double>::infinity();\n\n";
+        out << "inline double clamp(double value, double min, double max) { return value <= min ? min : value >= max ? max : value; }\n\n";
+        for (auto& c : m_curves)
+            out << "inline double " << curveName(c) << "(double t) { " << curveBodies().at(c) << " }\n";
+        if (!m_curves.empty())
+            out << "\n";
+        for (auto& f : m_funcs)
+            out << f << "\n";
+        out << "} // namespace\n\n";
+        out << "TACT_PLUGIN_EXPORT double tact_plugin_sample(double t) {\n    return n" << root << "(t);\n}\n\n";
+        out << "TACT_PLUGIN_EXPORT void tact_plugin_sample_block(const double* t, double* b, int n) {\n";
+        out << "    for (int i = 0; i < n; ++i)\n        b[i] = n" << root << "(t[i]);\n}\n\n";
+        out << "TACT_PLUGIN_EXPORT double tact_plugin_length() {\n    return " << lit(signal.length()) << ";\n}\n";
+        return true;
+    }
+
+private:
+
+    /// Formats a double literal which round trips exactly.
+    static std::string lit(double v) {
+        if (v == INF)
+            return "INF";
+        if (v == -INF)
+            return "(-INF)";
+        std::ostringstream ss;
+        ss << std::setprecision(17) << v;
+        std::string s = ss.str();
+        if (s.find_first_of(".en") == std::string::npos)
+            s += ".0";
+        return v < 0 ? "(" + s + ")" : s;
+    }
+
+    static std::string call(int id, const std::string& t) {
+        return "n" + std::to_string(id) + "(" + t + ")";
+    }
+
+    static std::string curveName(const std::string& name) {
+        std::string s = "curve";
+        for (char c : name) {
+            if (c != ':')
+                s += c;
+        }
+        return s;
+    }
+
+    /// Adds a function with body, reusing an identical one if it already exists.
+    int function(const std::string& body) {
+        auto it = m_bodies.find(body);
+        if (it != m_bodies.end())
+            return it->second;
+        int id = (int)m_funcs.size();
+        m_funcs.push_back("inline double n" + std::to_string(id) + "(double t) {\n" + body + "}\n");
+        m_bodies[body] = id;
+        return id;
+    }
+
+    /// Emits a function for a Signal including gain and bias. Returns -1 on failure.
+    int node(const Signal& sig) {
+        std::string pre, expr;
+        if (!model(sig, pre, expr))
+            return -1;
+        if (sig.gain != 1)
+            expr = "(" + expr + ") * " + lit(sig.gain);
+        if (sig.bias != 0)
+            expr = "(" + expr + ") + " + lit(sig.bias);
+        return function(pre + "    return " + expr + ";\n");
+    }
+
+    template <typename T>
+    bool oscillator(const Signal& sig, std::string& pre, const std::string& form, std::string& expr) {
+        int x = node(sig.getAs<T>()->x);
+        if (x < 0)
+            return false;
+        pre  = "    const double x = " + call(x, "t") + ";\n";
+        expr = form;
+        return true;
+    }
+
+    bool keyed(const KeyedEnvelope& env, std::string& expr) {
+        std::string body;
+        auto& keys = env.getKeys();
+        // a cleared envelope samples as zero, like KeyedEnvelope::sample
+        if (keys.empty()) {
+            expr = "0.0";
+            return true;
+        }
+        body += "    if (t > " + lit(keys.back().t) + ") return 0.0;\n";
+        body += "    if (t <= " + lit(keys.front().t) + ") return " + lit(keys.front().amplitude) + ";\n";
+        for (std::size_t i = 1; i < keys.size(); ++i) {
+            auto& a = keys[i-1];
+            auto& b = keys[i];
+            std::string curve = b.curve.name();
+            if (!curveBodies().count(curve))
+                return false;
+            m_curves.insert(curve);
+            body += "    if (t <= " + lit(b.t) + ") return t == " + lit(b.t) + " ? " + lit(b.amplitude) 
+                  + " : " + lit(a.amplitude) + " + " + lit(b.amplitude - a.amplitude) + " * " 
+                  + curveName(curve) + "((t - " + lit(a.t) + ") / " + lit(b.t - a.t) + ");\n";
+        }
+        body += "    return 0.0;\n";
+        expr = call(function(body), "t");
+        return true;
+    }
+
+    /// Generates the value of the type erased model of a Signal into expr.
+    bool model(const Signal& sig, std::string& pre, std::string& expr) {
+        auto id = sig.typeId();
+        if (id == typeid(Time))
+            expr = "t";
+        else if (id == typeid(Scalar))
+            expr = lit(sig.getAs<Scalar>()->value);
+        else if (id == typeid(Ramp)) 
+            expr = lit(sig.getAs<Ramp>()->initial) + " + " + lit(sig.getAs<Ramp>()->rate) + " * t";
+        else if (id == typeid(Sum) || id == typeid(Product)) {
+            auto op = (const IOperator*)sig.get();
+            int l = node(op->lhs);
+            int r = node(op->rhs);
+            if (l < 0 || r < 0)
+                return false;
+            expr = call(l, "t") + (id == typeid(Sum) ? " + " : " * ") + call(r, "t");
+        }
+        else if (id == typeid(Mix) || id == typeid(Modulation)) {
+            auto& signals = ((const INaryOperator*)sig.get())->signals;
+            expr = signals.empty() ? lit(id == typeid(Mix) ? 0.0 : 1.0) : "";
+            for (std::size_t i = 0; i < signals.size(); ++i) {
+                int k = node(signals[i]);
+                if (k < 0)
+                    return false;
+                expr += (i == 0 ? "" : id == typeid(Mix) ? " + " : " * ") + call(k, "t");
+            }
+        }
+        else if (id == typeid(Sine))
+            return oscillator<Sine>(sig, pre, "std::sin(x)", expr);
+        else if (id == typeid(Square))
+            return oscillator<Square>(sig, pre, "std::sin(x) > 0 ? 1.0 : -1.0", expr);
+        else if (id == typeid(Saw))
+            return oscillator<Saw>(sig, pre, "-2 * INV_PI * std::atan(std::cos(0.5 * x) / std::sin(0.5 * x))", expr);
+        else if (id == typeid(Triangle))
+            return oscillator<Triangle>(sig, pre, "2 * INV_PI * std::asin(std::sin(x))", expr);
+        else if (id == typeid(Pwm)) {
+            auto pwm = sig.getAs<Pwm>();
+            expr = "std::fmod(t, " + lit(1.0 / pwm->frequency) + ") * " + lit(pwm->frequency) + " < " + lit(pwm->dutyCycle) + " ? 1.0 : -1.0";
+        }
+        else if (id == typeid(Envelope)) {
+            auto env = sig.getAs<Envelope>();
+            expr = "t > " + lit(env->duration) + " ? 0.0 : " + lit(env->amplitude);
+        }
+        else if (id == typeid(ExponentialDecay)) {
+            auto env = sig.getAs<ExponentialDecay>();
+            expr = lit(env->amplitude) + " * std::exp(" + lit(-env->decay) + " * t)";
+        }
+        else if (id == typeid(KeyedEnvelope) || id == typeid(ASR) || id == typeid(ADSR))
+            return keyed(*(const KeyedEnvelope*)sig.get(), expr);
+        else if (id == typeid(SignalEnvelope)) {
+            auto env = sig.getAs<SignalEnvelope>();
+            int s = node(env->signal);
+            if (s < 0)
+                return false;
+            expr = "t > " + lit(env->length()) + " ? 0.0 : (" + call(s, "t") + " + 1.0) * " + lit(env->amplitude) + " / 2.0";
+        }
+        else if (id == typeid(Stretcher)) {
+            auto str = sig.getAs<Stretcher>();
+            int s = node(str->signal);
+            if (s < 0)
+                return false;
+            expr = call(s, "t / " + lit(str->factor));
+        }
+        else if (id == typeid(Reverser)) {
+            auto rev = sig.getAs<Reverser>();
+            int s = node(rev->signal);
+            if (s < 0)
+                return false;
+            double l = rev->signal.length();
+            l = l == INF ? 1000000000 : l;
+            expr = call(s, "clamp(" + lit(l) + " - t, 0, 1000000000)");
+        }
+        else if (id == typeid(Repeater)) {
+            auto rep = sig.getAs<Repeater>();
+            int s = node(rep->signal);
+            if (s < 0)
+                return false;
+            double sigLen = rep->signal.length();
+            double intLen = sigLen + rep->delay;
+            double maxLen = sigLen * rep->repetitions + rep->delay * (rep->repetitions - 1);
+            pre  = "    const double s = std::fmod(t, " + lit(intLen) + ");\n";
+            expr = "t <= " + lit(maxLen) + " && s <= " + lit(sigLen) + " ? " + call(s, "s") + " : 0.0";
+        }
+        else if (id == typeid(Sequence)) {
+            auto seq = sig.getAs<Sequence>();
+            expr = "0.0";
+            for (int k = 0; k < seq->keyCount(); ++k) {
+                auto& key = seq->getKey(k);
+                int s = node(*key.signal);
+                if (s < 0)
+                    return false;
+                std::string gain = key.gain != 1 ? lit(key.gain) + " * " : "";
+                expr += "\n        + (t >= " + lit(key.t) + " && t <= " + lit(key.t + key.signal->length()) 
+                      + " ? " + gain + call(s, "t - " + lit(key.t)) + " : 0.0)";
+            }
+        }
+        else
+            return false;
+        return true;
+    }
+
+    std::vector<std::string>   m_funcs;
+    std::map<std::string, int> m_bodies;
+    std::set<std::string>      m_curves;
+};
+
+} // namespace
+
+bool codegen(const Signal& signal, std::ostream& out) {
+    std::ostringstream ss;
+    if (!Generator().run(signal, ss))
+        return false;
+    out << ss.str();
+    return true;
+}
+
+} // namespace tact
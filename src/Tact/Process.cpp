@@ -1,4 +1,6 @@
 #include <Tact/Process.hpp>
+#include <algorithm>
+#include <cmath>
 
 namespace tact
 {
@@ -31,6 +33,24 @@ double Repeater::sample(double t) const
     return 0;
 }
 
+void Repeater::sample(const double* t, double* b, int n) const
+{
+    double sigLen = signal.length();
+    double intLen = sigLen + delay;
+    double maxLen = sigLen * repetitions + delay * (repetitions - 1);
+    double tt[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        for (int j = 0; j < m; ++j)
+            tt[j] = std::fmod(t[i + j], intLen);
+        signal.sample(tt, b + i, m);
+        for (int j = 0; j < m; ++j) {
+            if (t[i + j] > maxLen || tt[j] > sigLen)
+                b[i + j] = 0;
+        }
+    }
+}
+
 double Repeater::length() const
 {
     return signal.length() * repetitions + delay * (repetitions - 1);
@@ -48,11 +68,27 @@ double Stretcher::sample(double t) const
     return signal.sample(t / factor);
 }
 
+void Stretcher::sample(const double* t, double* b, int n) const
+{
+    double tt[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        for (int j = 0; j < m; ++j)
+            tt[j] = t[i + j] / factor;
+        signal.sample(tt, b + i, m);
+    }
+}
+
 double Stretcher::length() const
 {
     return signal.length() * factor;
 }
 
+bool Stretcher::isConstant() const
+{
+    return signal.isConstant();
+}
+
 Reverser::Reverser()
 {
 }
@@ -69,9 +105,122 @@ double Reverser::sample(double t) const
     return signal.sample(t);
 }
 
+void Reverser::sample(const double* t, double* b, int n) const
+{
+    double l = signal.length();
+    l = l == INF ? 1000000000 : l;
+    double tt[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        for (int j = 0; j < m; ++j)
+            tt[j] = clamp(l - t[i + j], 0, 1000000000);
+        signal.sample(tt, b + i, m);
+    }
+}
+
 double Reverser::length() const
 {
     return signal.length();
 }
 
+bool Reverser::isConstant() const
+{
+    return signal.isConstant();
+}
+
+TimeMap::Stage TimeMap::Stage::affine(double scale, double offset, double lo, double hi)
+{
+    Stage stage;
+    stage.scale  = scale;
+    stage.offset = offset;
+    stage.lo     = lo;
+    stage.hi     = hi;
+    return stage;
+}
+
+TimeMap::Stage TimeMap::Stage::repeat(double period, double active, double end)
+{
+    Stage stage;
+    stage.periodic = true;
+    stage.period   = period;
+    stage.active   = active;
+    stage.end      = end;
+    return stage;
+}
+
+TimeMap::TimeMap() : duration(INF)
+{
+}
+
+double TimeMap::sample(double t) const
+{
+    for (auto& s : stages) {
+        if (s.periodic) {
+            if (t > s.end)
+                return 0;
+            t = std::fmod(t, s.period);
+            if (t > s.active)
+                return 0;
+        }
+        else
+            t = clamp(s.scale * t + s.offset, s.lo, s.hi);
+    }
+    return signal.sample(t);
+}
+
+void TimeMap::sample(const double* t, double* b, int n) const
+{
+    double tt[SYNTACTS_BLOCK_SIZE];
+    bool keep[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        for (int j = 0; j < m; ++j) {
+            tt[j]   = t[i + j];
+            keep[j] = true;
+        }
+        for (auto& s : stages) {
+            if (!s.periodic) {
+                for (int j = 0; j < m; ++j)
+                    tt[j] = clamp(s.scale * tt[j] + s.offset, s.lo, s.hi);
+                continue;
+            }
+            // wrap incrementally while time moves forward by less than a period,
+            // calling fmod only to start the block or after a jump
+            double prev = tt[0];
+            double w    = std::fmod(prev, s.period);
+            for (int j = 0; j < m; ++j) {
+                double d = tt[j] - prev;
+                prev = tt[j];
+                if (j > 0) {
+                    if (w >= 0 && d >= 0 && d < s.period) {
+                        w += d;
+                        w -= w >= s.period ? s.period : 0;
+                    }
+                    else
+                        w = std::fmod(prev, s.period);
+                }
+                keep[j] = keep[j] && !(prev > s.end) && !(w > s.active);
+                tt[j]   = w;
+            }
+        }
+        signal.sample(tt, b + i, m);
+        for (int j = 0; j < m; ++j)
+            b[i + j] = keep[j] ? b[i + j] : 0;
+    }
+}
+
+double TimeMap::length() const
+{
+    return duration;
+}
+
+bool TimeMap::isConstant() const
+{
+    for (auto& s : stages) {
+        if (s.periodic)
+            return false;
+    }
+    return signal.isConstant();
+}
+
 } // namespace tact
@@ -0,0 +1,378 @@
+#include <Tact/Program.hpp>
+#include <Tact/General.hpp>
+#include <Tact/Operator.hpp>
+#include <Tact/Oscillator.hpp>
+#include <Tact/Process.hpp>
+#include <FastMath.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <utility>
+#include <limits>
+#include <map>
+#include <tuple>
+
+namespace tact
+{
+
+///////////////////////////////////////////////////////////////////////////////
+// COMPILER
+///////////////////////////////////////////////////////////////////////////////
+
+/// Lowers Signal graphs into Program instructions.
+class Compiler {
+public:
+    using Op = Program::Op;
+
+    Program run(const Signal& signal) {
+        Program p;
+        m_program = &p;
+        m_next = 1;
+        m_memo.clear();
+        m_tables.clear();
+        p.m_source = signal;
+        p.m_length = signal.length();
+        p.m_output = lower(signal, 0);
+        allocate();
+        return p;
+    }
+
+private:
+
+    /// Emits an instruction and returns its (virtual) destination register. If an identical
+    /// instruction was already emitted, its register is returned instead. Since lowering is
+    /// bottom up, this hash-conses structurally identical subgraphs into a single set of 
+    /// instructions which are evaluated once per block no matter how many times they're used.
+    int emit(Op op, int a, int b = -1, double k0 = 0, double k1 = 0, int idx = -1) {
+        if ((op == Op::Add || op == Op::Mul) && a > b)
+            std::swap(a, b);
+        Key key(op, a, b, bits(k0), bits(k1), idx);
+        auto it = m_memo.find(key);
+        if (it != m_memo.end())
+            return it->second;
+        int dst = m_next++;
+        m_program->m_code.push_back({op, dst, a, b, k0, k1, idx});
+        m_memo.emplace(key, dst);
+        return dst;
+    }
+
+    /// Returns the bit pattern of a constant so that memo keys are exact (and NaN safe).
+    static std::uint64_t bits(double k) {
+        std::uint64_t u;
+        std::memcpy(&u, &k, sizeof(k));
+        return u;
+    }
+
+    /// Returns the table index of an opaque node, adding it with add() if not yet seen. 
+    /// Nodes are identified by address, so shared nodes (see SYNTACTS_USE_SHARED_PTR) 
+    /// are only sampled once per block.
+    template <typename F>
+    int table(const Signal& sig, F add) {
+        auto it = m_tables.find(sig.get());
+        if (it != m_tables.end())
+            return it->second;
+        int idx = add();
+        m_tables.emplace(sig.get(), idx);
+        return idx;
+    }
+
+    /// Lowers a Signal sampled at times in register t, including its gain and bias.
+    int lower(const Signal& sig, int t) {
+        if (sig.isConstant())
+            return emit(Op::Const, -1, -1, sig.sample(0));
+        int r = lowerModel(sig, t);
+        if (sig.gain != 1 || sig.bias != 0)
+            r = emit(Op::Affine, r, -1, sig.gain, sig.bias);
+        return r;
+    }
+
+    template <typename T>
+    int lowerOscillator(const Signal& sig, int t, Op op) {
+        return emit(op, lower(sig.getAs<T>()->x, t));
+    }
+
+    int lowerKeyed(const Signal& sig, const KeyedEnvelope& env, int t) {
+        int idx = table(sig, [&]() {
+            m_program->m_envelopes.push_back(env);
+            return (int)m_program->m_envelopes.size() - 1;
+        });
+        return emit(Op::Keyed, t, -1, 0, 0, idx);
+    }
+
+    /// Lowers the type erased model of a Signal, ignoring its gain and bias.
+    int lowerModel(const Signal& sig, int t) {
+        auto id = sig.typeId();
+        if (id == typeid(Time))
+            return t;
+        else if (id == typeid(Scalar))
+            return emit(Op::Const, -1, -1, sig.getAs<Scalar>()->value);
+        else if (id == typeid(Ramp)) {
+            auto ramp = sig.getAs<Ramp>();
+            return emit(Op::Affine, t, -1, ramp->rate, ramp->initial);
+        }
+        else if (id == typeid(Sum)) {
+            auto op = sig.getAs<Sum>();
+            int l = lower(op->lhs, t);
+            int r = lower(op->rhs, t);
+            return emit(Op::Add, l, r);
+        }
+        else if (id == typeid(Product)) {
+            auto op = sig.getAs<Product>();
+            int l = lower(op->lhs, t);
+            int r = lower(op->rhs, t);
+            return emit(Op::Mul, l, r);
+        }
+        else if (id == typeid(Mix) || id == typeid(Modulation)) {
+            auto& signals = ((const INaryOperator*)sig.get())->signals;
+            if (signals.empty())
+                return emit(Op::Const, -1, -1, id == typeid(Mix) ? 0.0 : 1.0);
+            Op op = id == typeid(Mix) ? Op::Add : Op::Mul;
+            int out = lower(signals[0], t);
+            for (std::size_t i = 1; i < signals.size(); ++i)
+                out = emit(op, out, lower(signals[i], t));
+            return out;
+        }
+        else if (id == typeid(Sine))
+            return lowerOscillator<Sine>(sig, t, Op::Sin);
+        else if (id == typeid(Square))
+            return lowerOscillator<Square>(sig, t, Op::Square);
+        else if (id == typeid(Saw))
+            return lowerOscillator<Saw>(sig, t, Op::Saw);
+        else if (id == typeid(Triangle))
+            return lowerOscillator<Triangle>(sig, t, Op::Triangle);
+        else if (id == typeid(Pwm)) {
+            auto pwm = sig.getAs<Pwm>();
+            return emit(Op::Pwm, t, -1, pwm->frequency, pwm->dutyCycle);
+        }
+        else if (id == typeid(Envelope)) {
+            auto env = sig.getAs<Envelope>();
+            return emit(Op::Envelope, t, -1, env->duration, env->amplitude);
+        }
+        else if (id == typeid(ExponentialDecay)) {
+            auto env = sig.getAs<ExponentialDecay>();
+            return emit(Op::Decay, t, -1, env->amplitude, env->decay);
+        }
+        else if (id == typeid(KeyedEnvelope))
+            return lowerKeyed(sig, *sig.getAs<KeyedEnvelope>(), t);
+        else if (id == typeid(ASR))
+            return lowerKeyed(sig, *sig.getAs<ASR>(), t);
+        else if (id == typeid(ADSR))
+            return lowerKeyed(sig, *sig.getAs<ADSR>(), t);
+        else if (id == typeid(SignalEnvelope)) {
+            auto env = sig.getAs<SignalEnvelope>();
+            int v = lower(env->signal, t);
+            v = emit(Op::Affine, v, -1, 0.5 * env->amplitude, 0.5 * env->amplitude);
+            return emit(Op::Gate, t, v, -INF, env->duration);
+        }
+        else if (id == typeid(Stretcher)) {
+            auto str = sig.getAs<Stretcher>();
+            int tt = emit(Op::Affine, t, -1, 1.0 / str->factor, 0);
+            return lower(str->signal, tt);
+        }
+        else if (id == typeid(Reverser)) {
+            auto rev = sig.getAs<Reverser>();
+            double l = rev->signal.length();
+            l = l == INF ? 1000000000 : l;
+            int tt = emit(Op::Affine, t, -1, -1, l);
+            tt = emit(Op::Clamp, tt, -1, 0, 1000000000);
+            return lower(rev->signal, tt);
+        }
+        else if (id == typeid(Repeater)) {
+            auto rep = sig.getAs<Repeater>();
+            double sigLen = rep->signal.length();
+            double intLen = sigLen + rep->delay;
+            double maxLen = sigLen * rep->repetitions + rep->delay * (rep->repetitions - 1);
+            int tt = emit(Op::Wrap, t, -1, intLen);
+            int v  = lower(rep->signal, tt);
+            v = emit(Op::Gate, tt, v, -INF, sigLen);
+            return emit(Op::Gate, t, v, -INF, maxLen);
+        }
+        else if (id == typeid(TimeMap)) {
+            auto map = sig.getAs<TimeMap>();
+            // transform time, remembering the gates of periodic stages to apply to the result
+            std::vector<std::pair<int, double>> gates;
+            int tt = t;
+            for (auto& s : map->stages) {
+                if (s.periodic) {
+                    gates.push_back({tt, s.end});
+                    tt = emit(Op::Wrap, tt, -1, s.period);
+                    gates.push_back({tt, s.active});
+                }
+                else {
+                    tt = emit(Op::Affine, tt, -1, s.scale, s.offset);
+                    if (s.lo != -INF || s.hi != INF)
+                        tt = emit(Op::Clamp, tt, -1, s.lo, s.hi);
+                }
+            }
+            int v = lower(map->signal, tt);
+            for (auto g = gates.rbegin(); g != gates.rend(); ++g)
+                v = emit(Op::Gate, g->first, v, -INF, g->second);
+            return v;
+        }
+        // no instruction counterpart, so sample through the Signal interface
+        int idx = table(sig, [&]() {
+            Signal call = sig;
+            call.gain = 1;
+            call.bias = 0;
+            m_program->m_calls.push_back(std::move(call));
+            return (int)m_program->m_calls.size() - 1;
+        });
+        return emit(Op::Call, t, -1, 0, 0, idx);
+    }
+
+    /// Maps virtual registers to a minimal set of physical registers.
+    void allocate() {
+        auto& code = m_program->m_code;
+        std::vector<int> lastUse(m_next, -1);
+        for (int i = 0; i < (int)code.size(); ++i) {
+            if (code[i].a > 0) lastUse[code[i].a] = i;
+            if (code[i].b > 0) lastUse[code[i].b] = i;
+        }
+        lastUse[m_program->m_output] = std::numeric_limits<int>::max();
+        std::vector<int> phys(m_next, 0);
+        std::vector<int> free;
+        int count = 1;
+        auto acquire = [&]() { 
+            if (free.empty())
+                return count++;
+            int r = free.back(); 
+            free.pop_back(); 
+            return r;
+        };
+        auto release = [&](int v, int i) {
+            if (v > 0 && lastUse[v] == i) {
+                free.push_back(phys[v]);
+                lastUse[v] = -1;
+            }
+        };
+        for (int i = 0; i < (int)code.size(); ++i) {
+            auto& ins = code[i];
+            int a = ins.a, b = ins.b;
+            if (a >= 0) ins.a = phys[a];
+            if (b >= 0) ins.b = phys[b];
+            // element-wise instructions may write in place, but Call and Keyed 
+            // hand registers to code which may not support aliasing
+            bool inPlace = ins.op != Op::Call && ins.op != Op::Keyed;
+            if (inPlace) {
+                release(a, i);
+                release(b, i);
+            }
+            phys[ins.dst] = acquire();
+            ins.dst = phys[ins.dst];
+            if (!inPlace) {
+                release(a, i);
+                release(b, i);
+            }
+        }
+        m_program->m_output    = phys[m_program->m_output];
+        m_program->m_registers = count;
+    }
+
+    using Key = std::tuple<Op, int, int, std::uint64_t, std::uint64_t, int>;
+
+    Program* m_program;
+    int m_next;
+    std::map<Key, int> m_memo;           ///< emitted instructions -> destination register
+    std::map<const void*, int> m_tables; ///< opaque nodes -> envelope/call table index
+};
+
+///////////////////////////////////////////////////////////////////////////////
+// INTERPRETER
+///////////////////////////////////////////////////////////////////////////////
+
+namespace {
+struct Frame {
+    std::vector<double>  scratch;
+    std::vector<double*> regs;
+};
+}
+
+Program::Program() :
+    m_registers(1),
+    m_output(-1),
+    m_length(0)
+{ }
+
+double Program::sample(double t) const {
+    double b;
+    sample(&t, &b, 1);
+    return b;
+}
+
+void Program::sample(const double* t, double* b, int n) const {
+    if (m_output < 0) {
+        for (int i = 0; i < n; ++i)
+            b[i] = 0;
+        return;
+    }
+    // registers live in per-thread frames which grow to the largest Program sampled,
+    // one frame per nesting level so that embedded Programs don't clobber each other
+    thread_local std::deque<Frame> frames;
+    thread_local std::size_t depth = 0;
+    if (frames.size() == depth)
+        frames.emplace_back();
+    Frame& frame = frames[depth++];
+    std::size_t size = (std::size_t)m_registers * SYNTACTS_BLOCK_SIZE;
+    if (frame.scratch.size() < size)
+        frame.scratch.resize(size);
+    if (frame.regs.size() < (std::size_t)m_registers)
+        frame.regs.resize(m_registers);
+    auto& regs = frame.regs;
+    for (int r = 1; r < m_registers; ++r)
+        regs[r] = &frame.scratch[r * SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        regs[0] = const_cast<double*>(t + i);
+        for (auto& ins : m_code) {
+            double* d = regs[ins.dst];
+            const double* a = ins.a >= 0 ? regs[ins.a] : nullptr;
+            const double* c = ins.b >= 0 ? regs[ins.b] : nullptr;
+            const double k0 = ins.k0, k1 = ins.k1;
+            switch (ins.op) {
+            case Op::Const:    for (int j = 0; j < m; ++j) d[j] = k0; break;
+            case Op::Affine:   for (int j = 0; j < m; ++j) d[j] = a[j] * k0 + k1; break;
+            case Op::Add:      for (int j = 0; j < m; ++j) d[j] = a[j] + c[j]; break;
+            case Op::Mul:      for (int j = 0; j < m; ++j) d[j] = a[j] * c[j]; break;
+            case Op::Sin:      FastMath::sin(a, d, m); break;
+            case Op::Square:   FastMath::square(a, d, m); break;
+            case Op::Saw:      FastMath::saw(a, d, m); break;
+            case Op::Triangle: FastMath::triangle(a, d, m); break;
+            case Op::Pwm:      for (int j = 0; j < m; ++j) d[j] = std::fmod(a[j], 1.0 / k0) * k0 < k1 ? 1.0 : -1.0; break;
+            case Op::Envelope: for (int j = 0; j < m; ++j) d[j] = a[j] > k0 ? 0.0 : k1; break;
+            case Op::Decay:    FastMath::exp(a, d, m, k0, -k1); break;
+            case Op::Wrap:     for (int j = 0; j < m; ++j) d[j] = std::fmod(a[j], k0); break;
+            case Op::Clamp:    for (int j = 0; j < m; ++j) d[j] = clamp(a[j], k0, k1); break;
+            case Op::Gate:     for (int j = 0; j < m; ++j) d[j] = a[j] >= k0 && a[j] <= k1 ? c[j] : 0.0; break;
+            case Op::Keyed:    m_envelopes[ins.idx].sample(a, d, m); break;
+            case Op::Call:     m_calls[ins.idx].sample(a, d, m); break;
+            }
+        }
+        const double* out = regs[m_output];
+        for (int j = 0; j < m; ++j)
+            b[i + j] = out[j];
+    }
+    depth--;
+}
+
+double Program::length() const {
+    return m_length;
+}
+
+const Signal& Program::source() const {
+    return m_source;
+}
+
+const std::vector<Program::Instruction>& Program::instructions() const {
+    return m_code;
+}
+
+int Program::registerCount() const {
+    return m_registers;
+}
+
+Program compile(const Signal& signal) {
+    return Compiler().run(signal);
+}
+
+} // namespace tact
@@ -1,4 +1,5 @@
 #include <Tact/Sequence.hpp>
+#include <Tact/Util.hpp>
 #include <iostream>
 #include <algorithm>
 
@@ -14,46 +15,163 @@ Sequence& Sequence::push(double t) {
 }
 
 Sequence& Sequence::push(Signal signal) {
-    insert(signal, head);
-    head += signal.length();
+    double length = signal.length();
+    insert(std::move(signal), head);
+    head += length;
     return *this;
 }
 
 Sequence& Sequence::push(Sequence sequence) {
-    insert(sequence, head);
-    head += sequence.length();
+    double length = sequence.length();
+    insert(std::move(sequence), head);
+    head += length;
     return *this;
 }
 
 Sequence& Sequence::insert(Signal signal, double t) 
 {
     m_length = std::max(m_length, t + signal.length());
-    m_keys.push_back({t, std::move(signal)});
+    const Signal& sig = signal;
+    if (sig.isType<Sequence>() && sig.bias == 0) {
+        for (auto& k : sig.getAs<Sequence>()->m_keys)
+            insert(Key{k.t, k.gain * sig.gain, k.signal}, t);
+        return *this;
+    }
+    m_keys.push_back({t, 1, std::make_shared<const Signal>(std::move(signal))});
+    indexLast();
     return *this;
 }
 
 Sequence& Sequence::insert(Sequence sequence, double t) {
     m_length = std::max(m_length, t + sequence.length());
     for (auto& k : sequence.m_keys)
-        insert(k.signal, t + k.t);
+        insert(k, t);
+    return *this;
+}
+
+Sequence& Sequence::insert(const Key& key, double t) {
+    m_length = std::max(m_length, t + key.t + key.signal->length());
+    m_keys.push_back({t + key.t, key.gain, key.signal});
+    indexLast();
     return *this;
 }
 
+void Sequence::indexLast() {
+    int key = static_cast<int>(m_keys.size()) - 1;
+    double start  = m_keys[key].t;
+    double length = m_keys[key].signal->length();
+    Span span{start, start + length, length, m_keys[key].gain, key};
+    if (m_spans.empty() || start >= m_spans.back().start) {
+        // keys pushed in time order append, updating only their path in the tree
+        m_spans.push_back(span);
+        std::size_t cap = m_tree.size() / 2;
+        if (m_spans.size() > cap) 
+            buildTree();
+        else {
+            std::size_t node = cap + m_spans.size() - 1;
+            m_tree[node] = span.end;
+            for (node /= 2; node >= 1; node /= 2)
+                m_tree[node] = std::max(m_tree[2 * node], m_tree[2 * node + 1]);
+        }
+    }
+    else {
+        auto it = std::upper_bound(m_spans.begin(), m_spans.end(), start, [](double t, const Span& s) { return t < s.start; });
+        m_spans.insert(it, span);
+        buildTree();
+    }
+}
+
+void Sequence::index() {
+    m_spans.clear();
+    m_spans.reserve(m_keys.size());
+    for (int i = 0; i < static_cast<int>(m_keys.size()); ++i) {
+        double length = m_keys[i].signal->length();
+        m_spans.push_back({m_keys[i].t, m_keys[i].t + length, length, m_keys[i].gain, i});
+    }
+    std::stable_sort(m_spans.begin(), m_spans.end(), [](const Span& a, const Span& b) { return a.start < b.start; });
+    buildTree();
+}
+
+void Sequence::buildTree() {
+    std::size_t cap = 1;
+    while (cap < m_spans.size())
+        cap *= 2;
+    m_tree.assign(2 * cap, -INF);
+    for (std::size_t i = 0; i < m_spans.size(); ++i)
+        m_tree[cap + i] = m_spans[i].end;
+    for (std::size_t node = cap - 1; node >= 1; --node)
+        m_tree[node] = std::max(m_tree[2 * node], m_tree[2 * node + 1]);
+}
+
+template <typename F>
+void Sequence::overlapping(double t0, double t1, F&& f) const {
+    // spans [0,hi) start before t1; of those, descend only into subtrees ending after t0
+    std::size_t hi = std::upper_bound(m_spans.begin(), m_spans.end(), t1, [](double t, const Span& s) { return t < s.start; }) - m_spans.begin();
+    if (hi == 0)
+        return;
+    struct Node { std::size_t node, lo, width; };
+    Node stack[64];
+    int sp = 0;
+    stack[sp++] = {1, 0, m_tree.size() / 2};
+    while (sp > 0) {
+        Node n = stack[--sp];
+        if (n.lo >= hi || m_tree[n.node] < t0)
+            continue;
+        if (n.width == 1) {
+            f(m_spans[n.lo]);
+            continue;
+        }
+        std::size_t half = n.width / 2;
+        stack[sp++] = {2 * n.node + 1, n.lo + half, half};
+        stack[sp++] = {2 * n.node, n.lo, half};
+    }
+}
+
 double Sequence::sample(double t) const {
     double sample = 0;
-    for (auto& k : m_keys) {
-        if (t >= k.t && t <= k.t + k.signal.length())
-            sample += k.signal.sample(t - k.t);
-    }
+    overlapping(t, t, [&](const Span& s) {
+        sample += s.gain * m_keys[s.key].signal->sample(t - s.start);
+    });
     return sample;
 }
 
+void Sequence::sample(const double* t, double* b, int n) const {
+    double tt[SYNTACTS_BLOCK_SIZE];
+    double tmp[SYNTACTS_BLOCK_SIZE];
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        int m = std::min(n - i, SYNTACTS_BLOCK_SIZE);
+        auto range = std::minmax_element(t + i, t + i + m);
+        double tmin = *range.first;
+        double tmax = *range.second;
+        for (int j = 0; j < m; ++j)
+            b[i + j] = 0;
+        // only the keys active during this block are visited
+        overlapping(tmin, tmax, [&](const Span& s) {
+            for (int j = 0; j < m; ++j)
+                tt[j] = t[i + j] - s.start;
+            m_keys[s.key].signal->sample(tt, tmp, m);
+            for (int j = 0; j < m; ++j) {
+                if (tt[j] >= 0 && tt[j] <= s.length)
+                    b[i + j] += s.gain * tmp[j];
+            }
+        });
+    }
+}
+
 double Sequence::length() const {
     return m_length;
 }
 
+Interval Sequence::support() const {
+    if (m_spans.empty())
+        return {INF, -INF};
+    return {m_spans.front().start, m_tree[1]};
+}
+
 void Sequence::clear() {
     m_keys.clear();
+    m_spans.clear();
+    m_tree.clear();
     head = 0;
     m_length = 0;
 }
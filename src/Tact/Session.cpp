@@ -1,5 +1,6 @@
 #include "misc/SPSCQueue.h"
 #include <Tact/Session.hpp>
+#include <Tact/Optimizer.hpp>
 #include <cassert>
 #include "portaudio.h"
 #include "pa_asio.h"
@@ -35,15 +36,24 @@ static std::array<double,13> STANDARD_SAMPLE_RATES = {
 
 using namespace rigtorp;
 
+#ifdef SYNTACTS_USE_FLOAT
+using Sample = float;  ///< precision of voice mixing, pitch and volume ramps, and metering
+#else
+using Sample = double; ///< precision of voice mixing, pitch and volume ramps, and metering
+#endif
+
 struct Voice {
     Signal signal;
     double time  = 0;
     bool stopped = true;
-    inline double step(double dt) {
-        double s = signal.sample(time) * (!stopped);
+    /// Samples n frames offset from the current time by ofs into b and then advances time by dt.
+    inline void step(const Sample* ofs, double* b, int n, double dt) {
+        double t[SYNTACTS_BLOCK_SIZE];
+        for (int i = 0; i < n; ++i)
+            t[i] = time + ofs[i];
+        signal.sample(t, b, n);
         time += dt;
-        return s;
-    }    
+    }
 };
 
 /// Channel structure
@@ -75,16 +85,33 @@ public:
             }
         }
         else {
-            // fill buffer
-            double max_level = 0;
-            for (unsigned long f = 0; f < frames; ++f) {
-                pitch += pitchIncr;
-                volume += volumeIncr;
-                double dt = sampleLength * pitch;
-                double output = stepVoices(dt) * volume;
-                double abs_out = std::abs(output);
-                max_level = abs_out > max_level ? abs_out : max_level;
-                buffer[f] = static_cast<float>(output);
+            // fill buffer in blocks
+            Sample max_level = 0;
+            Sample ofs[SYNTACTS_BLOCK_SIZE];
+            Sample vol[SYNTACTS_BLOCK_SIZE];
+            Sample out[SYNTACTS_BLOCK_SIZE];
+            for (unsigned long f = 0; f < frames; f += SYNTACTS_BLOCK_SIZE) {
+                int n = static_cast<int>(std::min<unsigned long>(frames - f, SYNTACTS_BLOCK_SIZE));
+                // time offsets within the block accumulate the linear pitch ramp, so evaluate 
+                // them in closed form (they are small, so only the voice times need double)
+                const Sample len  = static_cast<Sample>(sampleLength);
+                const Sample p0   = static_cast<Sample>(pitch);
+                const Sample incr = static_cast<Sample>(pitchIncr);
+                for (int i = 0; i < n; ++i)
+                    ofs[i] = len * (i * p0 + Sample(0.5) * (i * (i + 1)) * incr);
+                double dt = sampleLength * (n * pitch + 0.5 * (n * (n + 1)) * pitchIncr);
+                pitch += n * pitchIncr;
+                // the volume ramp is linear, so evaluate it in closed form
+                for (int i = 0; i < n; ++i)
+                    vol[i] = static_cast<Sample>(volume + (i + 1) * volumeIncr);
+                volume += n * volumeIncr;
+                stepVoices(ofs, out, n, dt);
+                for (int i = 0; i < n; ++i) {
+                    Sample output  = out[i] * vol[i];
+                    Sample abs_out = std::abs(output);
+                    max_level = abs_out > max_level ? abs_out : max_level;
+                    buffer[f + i] = static_cast<float>(output);
+                }
             }
             level = max_level; // sum_output / frames;
         }
@@ -119,11 +146,17 @@ public:
         paused = true;
     }
 
-    inline double stepVoices(double dt) {
-        double sum = 0;
-        for (auto& v : voices)
-            sum += v.step(dt);
-        return sum;
+    inline void stepVoices(const Sample* ofs, Sample* out, int n, double dt) {
+        double b[SYNTACTS_BLOCK_SIZE];
+        for (int i = 0; i < n; ++i)
+            out[i] = 0;
+        for (auto& v : voices) {
+            if (v.stopped)
+                continue;
+            v.step(ofs, b, n, dt);
+            for (int i = 0; i < n; ++i)
+                out[i] += static_cast<Sample>(b[i]);
+        }
     }
 
     inline int activeVoices() {
@@ -477,6 +510,14 @@ public:
         return m_sampleRate;
     }
 
+    void setAutoOptimize(bool enabled) {
+        m_autoOptimize = enabled;
+    }
+
+    bool getAutoOptimize() const {
+        return m_autoOptimize;
+    }
+
     double getCpuLoad() const {
         if (isOpen())
             return Pa_GetStreamCpuLoad(m_stream);
@@ -608,6 +649,8 @@ public:
 
     double m_sampleRate = 0;
 
+    bool m_autoOptimize = false;
+
     static int s_count;
 };
 
@@ -680,6 +723,8 @@ bool Session::isOpen() const {
 }
 
 int Session::play(int channel, Signal signal) {
+    if (getAutoOptimize())
+        signal = optimize(signal);
     return m_impl->play(channel, std::move(signal));
 }
 
@@ -692,8 +737,11 @@ bool Session::isPaused(int channel) {
 }
 
 int Session::playAll(Signal signal) {
+    // optimize once rather than per channel
+    if (getAutoOptimize())
+        signal = optimize(signal);
     for (int i = 0; i < getChannelCount(); ++i) {
-        if (int ret = play(i, signal) != SyntactsError_NoError)
+        if (int ret = m_impl->play(i, signal) != SyntactsError_NoError)
             return ret;
     }
     return SyntactsError_NoError;
@@ -780,6 +828,14 @@ double Session::getCpuLoad() const {
     return m_impl->getCpuLoad();
 }
 
+void Session::setAutoOptimize(bool enabled) {
+    m_impl->setAutoOptimize(enabled);
+}
+
+bool Session::getAutoOptimize() const {
+    return m_impl->getAutoOptimize();
+}
+
 int Session::count() {
     return Impl::count();
 }
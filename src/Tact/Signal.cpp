@@ -1,20 +1,117 @@
 #include <Tact/Signal.hpp>
+#include <Tact/Operator.hpp>
+#include <Tact/Oscillator.hpp>
+#include <Tact/Envelope.hpp>
+#include <Tact/Process.hpp>
+#include <Tact/Sequence.hpp>
+#include <Tact/Program.hpp>
+#include <Tact/Plugin.hpp>
+#include <algorithm>
 
 namespace tact
 {
 
-Signal::Signal() : Signal(Scalar(0)) {}
+namespace {
+
+/// Returns the bytes a pool block needs to store a Model<T> (plus the reference counts
+/// allocated along with it if SYNTACTS_USE_SHARED_PTR is enabled)
+template <typename T>
+constexpr std::size_t poolBytes() {
+#ifdef SYNTACTS_USE_SHARED_PTR
+    return 2 * sizeof(void*) + sizeof(Signal::Model<T>);
+#else
+    return sizeof(Signal::Model<T>);
+#endif
+}
+
+template <typename... Ts>
+constexpr std::size_t maxPoolBytes() {
+    return std::max({poolBytes<Ts>()...});
+}
+
+// checked even if SYNTACTS_USE_POOL is disabled, so that enabling it always compiles
+static_assert(maxPoolBytes<Scalar, Time, Ramp, Noise, Expression, PolyBezier, Samples, Sum, Product, Mix, 
+                           Modulation, Sequence, Sine, Square, Saw, Triangle, WavetableSine, WavetableSquare, 
+                           WavetableSaw, WavetableTriangle, Pwm, Envelope, KeyedEnvelope, ASR, ADSR, 
+                           ExponentialDecay, SignalEnvelope, Repeater, Stretcher, Reverser, TimeMap, 
+                           Program, Plugin>() <= SYNTACTS_POOL_BLOCK_SIZE, 
+              "SYNTACTS_POOL_BLOCK_SIZE is too small to store every built-in Signal type");
+
+} // namespace
+
+#ifdef SYNTACTS_USE_SHARED_PTR
+    Signal::Signal() : gain(1), bias(0)
+    {
+        // all default Signals share one immutable zero node
+        static const std::shared_ptr<const Concept> s_zero = Signal(Scalar(0)).m_ptr;
+        m_ptr = s_zero;
+    }
+    void Signal::detach()
+    {
+        if (m_ptr.use_count() > 1)
+            m_ptr = m_ptr->copy();
+    }
+#else
+    Signal::Signal() : Signal(Scalar(0)) {}
+#endif
 
 #ifndef SYNTACTS_USE_SHARED_PTR
     Signal::Signal(const Signal& other) :
         gain(other.gain),
         bias(other.bias),
-        m_ptr(other.m_ptr->copy())
+        m_ptr(other.m_ptr->copy(m_buffer))
     {  }
+    Signal::Signal(Signal&& other) noexcept :
+        gain(other.gain),
+        bias(other.bias),
+        m_ptr(nullptr)
+    {
+        steal(other);
+    }
     Signal& Signal::operator=(const Signal& other)
     {
         return *this = Signal(other);
     }
+    Signal& Signal::operator=(Signal&& other) noexcept
+    {
+        if (this != &other) {
+            destroy();
+            gain = other.gain;
+            bias = other.bias;
+            steal(other);
+        }
+        return *this;
+    }
+    Signal::~Signal()
+    {
+        destroy();
+    }
+    void Signal::steal(Signal& other) noexcept
+    {
+        // inline Models are always nothrow movable, so this never allocates
+        if (other.isInline())
+            m_ptr = other.m_ptr->move(m_buffer);
+        else {
+            m_ptr = other.m_ptr;
+            other.m_ptr = nullptr;
+        }
+    }
+    void Signal::destroy() noexcept
+    {
+        if (!m_ptr)
+            return;
+        if (isInline())
+            m_ptr->~Concept();
+        else {
+#ifdef SYNTACTS_USE_POOL
+            m_ptr->~Concept();
+            Signal::pool().deallocate(m_ptr);
+#else
+            delete m_ptr;
+#endif
+        }
+        m_ptr = nullptr;
+    }
 #endif // SYNTACTS_USE_SHARED_PTR
 
 std::type_index Signal::typeId() const
@@ -22,7 +119,17 @@ std::type_index Signal::typeId() const
     return m_ptr->typeId(); 
 }
 
-void* Signal::get() const
+void* Signal::get()
+{ 
+#ifdef SYNTACTS_USE_SHARED_PTR
+    detach();
+#endif
+    // the caller may mutate the model, so its cached length etc. can't be trusted
+    m_ptr->invalidate();
+    return m_ptr->get(); 
+}
+
+const void* Signal::get() const
 { 
     return m_ptr->get(); 
 }
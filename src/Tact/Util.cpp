@@ -43,6 +43,8 @@ const std::string& signalName(const Signal& signal) {
         // Operator.hpp
         {typeid(Sum),              "Sum"},
         {typeid(Product),          "Product"},
+        {typeid(Mix),              "Mix"},
+        {typeid(Modulation),       "Modulation"},
         // Sequence.hpp  
         {typeid(Sequence),         "Sequence"},
         // Oscillator.hpp
@@ -50,6 +52,10 @@ const std::string& signalName(const Signal& signal) {
         {typeid(Square),           "Square"},
         {typeid(Saw),              "Saw"},
         {typeid(Triangle),         "Triangle"},
+        {typeid(WavetableSine),    "Wavetable Sine"},
+        {typeid(WavetableSquare),  "Wavetable Square"},
+        {typeid(WavetableSaw),     "Wavetable Saw"},
+        {typeid(WavetableTriangle),"Wavetable Triangle"},
         {typeid(Pwm),              "PWM"},
         // Envelope.hpp
         {typeid(Envelope),         "Envelope"},
@@ -61,7 +67,12 @@ const std::string& signalName(const Signal& signal) {
         // Process.hpp
         {typeid(Repeater),         "Repeater"},
         {typeid(Stretcher),        "Stretcher"},
-        {typeid(Reverser),         "Reverser"}};
+        {typeid(Reverser),         "Reverser"},
+        {typeid(TimeMap),          "TimeMap"},
+        // Program.hpp
+        {typeid(Program),          "Program"},
+        // Plugin.hpp
+        {typeid(Plugin),           "Plugin"}};
     if (names.count(id))
         return names[id];
     else
@@ -79,11 +90,15 @@ void recurseSignalPriv(const Signal& sig, std::function<void(const Signal&, int
         recurseSignalPriv(sig.getAs<Product>()->lhs,func,depth+1);
         recurseSignalPriv(sig.getAs<Product>()->rhs,func,depth+1);
     }
+    else if (id == typeid(Mix) || id == typeid(Modulation)) {
+        for (auto& s : ((const INaryOperator*)sig.get())->signals)
+            recurseSignalPriv(s,func,depth+1);
+    }
     else if (id == typeid(Sequence)) {
         auto seq = sig.getAs<Sequence>();
         int K = seq->keyCount();
         for (int k = 0; k < K; ++k)
-            recurseSignalPriv(seq->getKey(k).signal,func,depth+1);
+            recurseSignalPriv(*seq->getKey(k).signal,func,depth+1);
     }
     else if (id == typeid(Repeater))
         recurseSignalPriv(sig.getAs<Repeater>()->signal,func,depth+1);
@@ -91,6 +106,8 @@ void recurseSignalPriv(const Signal& sig, std::function<void(const Signal&, int
         recurseSignalPriv(sig.getAs<Stretcher>()->signal,func,depth+1);
     else if (id == typeid(Reverser))
         recurseSignalPriv(sig.getAs<Reverser>()->signal,func,depth+1);   
+    else if (id == typeid(TimeMap))
+        recurseSignalPriv(sig.getAs<TimeMap>()->signal,func,depth+1);
     else if (id == typeid(Sine))
          recurseSignalPriv(sig.getAs<Sine>()->x,func,depth+1);
     else if (id == typeid(Square))
@@ -99,6 +116,8 @@ void recurseSignalPriv(const Signal& sig, std::function<void(const Signal&, int
          recurseSignalPriv(sig.getAs<Saw>()->x,func,depth+1);
     else if (id == typeid(Triangle))
          recurseSignalPriv(sig.getAs<Triangle>()->x,func,depth+1);
+    else if (id == typeid(WavetableSine) || id == typeid(WavetableSquare) || id == typeid(WavetableSaw) || id == typeid(WavetableTriangle))
+         recurseSignalPriv(((const IOscillator*)sig.get())->x,func,depth+1);
     else if (id == typeid(SignalEnvelope))
          recurseSignalPriv(sig.getAs<SignalEnvelope>()->signal,func,depth+1);
 }
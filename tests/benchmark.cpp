@@ -42,6 +42,55 @@ int main(int argc, char const *argv[])
     }
     display(toc(), n, sum, "Auto");
 
+    std::vector<double> tBlock(SYNTACTS_BLOCK_SIZE);
+    std::vector<double> sBlock(SYNTACTS_BLOCK_SIZE);
+    sum = 0;
+    tic();
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        for (int j = 0; j < SYNTACTS_BLOCK_SIZE; ++j)
+            tBlock[j] = (i + j) * lenN;
+        sig.sample(tBlock.data(), sBlock.data(), SYNTACTS_BLOCK_SIZE);
+        for (int j = 0; j < SYNTACTS_BLOCK_SIZE; ++j)
+            sum += sBlock[j];
+    }
+    display(toc(), n, sum, "Block");
+
+    Signal prog = compile(sig);
+    sum = 0;
+    tic();
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        for (int j = 0; j < SYNTACTS_BLOCK_SIZE; ++j)
+            tBlock[j] = (i + j) * lenN;
+        prog.sample(tBlock.data(), sBlock.data(), SYNTACTS_BLOCK_SIZE);
+        for (int j = 0; j < SYNTACTS_BLOCK_SIZE; ++j)
+            sum += sBlock[j];
+    }
+    display(toc(), n, sum, "Compiled");
+
+    Signal stat = Static::Sine(Static::Time() * (2 * PI * 175) + 2 * Static::Sine(10)) * Static::Envelope();
+    sum = 0;
+    tic();
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        for (int j = 0; j < SYNTACTS_BLOCK_SIZE; ++j)
+            tBlock[j] = (i + j) * lenN;
+        stat.sample(tBlock.data(), sBlock.data(), SYNTACTS_BLOCK_SIZE);
+        for (int j = 0; j < SYNTACTS_BLOCK_SIZE; ++j)
+            sum += sBlock[j];
+    }
+    display(toc(), n, sum, "Static");
+
+    Signal tone = Sine(175) * env;
+    sum = 0;
+    tic();
+    for (int i = 0; i < n; i += SYNTACTS_BLOCK_SIZE) {
+        for (int j = 0; j < SYNTACTS_BLOCK_SIZE; ++j)
+            tBlock[j] = (i + j) * lenN;
+        tone.sample(tBlock.data(), sBlock.data(), SYNTACTS_BLOCK_SIZE);
+        for (int j = 0; j < SYNTACTS_BLOCK_SIZE; ++j)
+            sum += sBlock[j];
+    }
+    display(toc(), n, sum, "Tone Block");
+
     sig = Expression("sin(2*pi*175*t+2*sin(2*pi*10*t))") * env;
     sum = 0;
     tic();
@@ -0,0 +1,127 @@
+// Checks that Signals saved by Syntacts 1.3 still load. The types that wrote those files have
+// since changed, so the files are written here field by field in the layout cereal gave them.
+
+#include <syntacts>
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/string.hpp>
+#include <cereal/types/vector.hpp>
+#include <fstream>
+#include <iostream>
+#include <map>
+
+using namespace tact;
+
+/// Writes Signals in the binary layout of Syntacts 1.3
+class OldArchive {
+public:
+    OldArchive(const std::string& path) : m_file(path, std::ios::binary), m_archive(m_file) { }
+    /// Writes a Signal's gain and bias and the header of its Model, whose members follow
+    void signal(const std::string& model, double gain = 1, double bias = 0) {
+        m_archive(gain, bias);
+        auto it = m_ids.find(model);
+        if (it != m_ids.end()) {
+            m_archive(it->second);
+        }
+        else {
+            // polymorphic id, followed by the name the first time it is written
+            std::uint32_t id = static_cast<std::uint32_t>(m_ids.size() + 1);
+            m_ids[model] = id;
+            m_archive(id | 0x80000000u, model);
+        }
+        m_archive(std::uint8_t(1)); // unique_ptr is not null
+    }
+    /// Writes the count of a container whose elements follow
+    void size(std::uint64_t n) {
+        m_archive(cereal::make_size_tag(n));
+    }
+    template <typename... Args>
+    void operator()(Args&&... args) {
+        m_archive(std::forward<Args>(args)...);
+    }
+private:
+    std::ofstream m_file;
+    cereal::BinaryOutputArchive m_archive;
+    std::map<std::string, std::uint32_t> m_ids;
+};
+
+int failures = 0;
+
+void check(const std::string& what, bool result) {
+    std::cout << (result ? "Pass: " : "Fail: ") << what << std::endl;
+    failures += !result;
+}
+
+/// Saves signal in the current layout and loads it back
+Signal roundTrip(const Signal& signal, const std::string& path) {
+    Signal loaded;
+    check("save " + path, Library::exportSignal(signal, path));
+    check("load " + path, Library::importSignal(loaded, path));
+    return loaded;
+}
+
+int main(int argc, char const *argv[])
+{
+    // Sequence Keys held a time and a Signal, before they shared Signal instances
+    {
+        OldArchive archive("compat_sequence.sig");
+        archive.signal("tact::Signal::Model<tact::Sequence>");
+        archive(0.75); // head
+        archive.size(2);
+        archive(0.0);
+        archive.signal("tact::Signal::Model<tact::Scalar>");
+        archive(0.5);
+        archive(0.3);
+        archive.signal("tact::Signal::Model<tact::Scalar>", 2);
+        archive(0.25);
+        archive(0.75); // length
+    }
+    Signal seq;
+    check("load 1.3 Sequence", Library::importSignal(seq, "compat_sequence.sig") && seq.isType<Sequence>());
+    if (seq.isType<Sequence>()) {
+        auto s = seq.getAs<Sequence>();
+        check("1.3 Sequence Keys", s->keyCount() == 2 && s->head == 0.75 &&
+              s->getKey(1).t == 0.3 && s->getKey(1).gain == 1 &&
+              s->getKey(1).signal->gain == 2 && s->getKey(1).signal->sample(0) == 0.5);
+        Signal copy = roundTrip(seq, "compat_sequence2.sig");
+        check("Sequence round trip", copy.isType<Sequence>() && copy.getAs<Sequence>()->keyCount() == 2 &&
+              copy.sample(0.1) == seq.sample(0.1) && copy.sample(0.4) == seq.sample(0.4));
+    }
+
+    // Noise was archived without members
+    {
+        OldArchive archive("compat_noise.sig");
+        archive.signal("tact::Signal::Model<tact::Noise>", 0.5);
+    }
+    Signal noise;
+    check("load 1.3 Noise", Library::importSignal(noise, "compat_noise.sig") && noise.isType<Noise>() &&
+          noise.gain == 0.5 && noise.getAs<Noise>()->type == Noise::Type::Uniform);
+    {
+        Signal pink = Noise(Noise::Type::Pink, 42);
+        Signal copy = roundTrip(pink, "compat_noise2.sig");
+        check("Noise round trip", copy.isType<Noise>() && copy.getAs<Noise>()->type == Noise::Type::Pink &&
+              copy.getAs<Noise>()->seed == 42);
+    }
+
+    // Samples were archived without interpolation, behind a shared_ptr to the recording
+    {
+        OldArchive archive("compat_samples.sig");
+        archive.signal("tact::Signal::Model<tact::Samples>");
+        archive(1000.0); // sample rate
+        // shared_ptr id, followed by the recording the first time it is written
+        archive(std::uint32_t(1) | 0x80000000u, std::vector<float>{0.0f, 0.5f, 1.0f});
+    }
+    Signal samples;
+    check("load 1.3 Samples", Library::importSignal(samples, "compat_samples.sig") && samples.isType<Samples>());
+    if (samples.isType<Samples>()) {
+        auto s = samples.getAs<Samples>();
+        check("1.3 Samples data", s->sampleRate() == 1000 && s->sampleCount() == 3 && s->getSample(1) == 0.5 &&
+              s->interpolation == Interpolation::Nearest);
+        Samples cubic = *s;
+        cubic.interpolation = Interpolation::Cubic;
+        Signal copy = roundTrip(cubic, "compat_samples2.sig");
+        check("Samples round trip", copy.isType<Samples>() && copy.getAs<Samples>()->sampleCount() == 3 &&
+              copy.getAs<Samples>()->interpolation == Interpolation::Cubic);
+    }
+
+    return failures;
+}
@@ -0,0 +1,47 @@
+// Generates a C++ translation unit from a Syntacts Signal which can be built
+// as a shared library and played with tact::Plugin, e.g.:
+//
+//     codegen funky funky.cpp
+//     g++ -O3 -shared -fPIC funky.cpp -o funky.so
+//
+//     Signal sig = Plugin("funky.so");
+
+#include <syntacts>
+#include <fstream>
+#include <iostream>
+
+using namespace tact;
+
+int main(int argc, char const *argv[])
+{
+    if (argc != 3) {
+        std::cout << "Usage: codegen <library signal name or file path> <output .cpp path>" << std::endl;
+        return 1;
+    }
+
+    std::string input  = argv[1];
+    std::string output = argv[2];
+
+    // load from file if it has an extension, otherwise from the Syntacts library
+    Signal sig;
+    bool loaded = input.find('.') != std::string::npos 
+                ? Library::importSignal(sig, input) 
+                : Library::loadSignal(sig, input);
+    if (!loaded) {
+        std::cout << "Failed to load Signal " << input << std::endl;
+        return 1;
+    }
+
+    std::ofstream file(output);
+    if (!file.is_open()) {
+        std::cout << "Failed to open " << output << std::endl;
+        return 1;
+    }
+    if (!codegen(sig, file)) {
+        std::cout << "Signal " << input << " contains types which can't be generated" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Generated " << output << " from " << signalName(sig) << " Signal " << input << std::endl;
+    return 0;
+}